@@ -0,0 +1,88 @@
+/**
+ * @file Micro-benchmark of the boolean meet kernels
+ *
+ * Applies the intersect, union and and-not kernels of every instruction set
+ * supported by the host CPU to domain values of 64 bits up to 1M bits, and
+ * reports the average time per meet.
+ *
+ * The destination is restored before every meet, so that each of them
+ * actually changes it rather than hitting the fixpoint after the first one.
+ * The time of the restoring copy alone is measured as well and subtracted.
+ */
+#include <DFA/MeetKernels.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace dfa::kernel;
+
+namespace {
+
+/// @brief Total number of bits processed for each (kernel, size) pair, so that
+///        small domain values are repeated enough to be measurable.
+constexpr std::size_t BitsPerMeasurement = std::size_t(1) << 32;
+
+/// @brief Kernel that leaves the destination as is, for timing the copy that
+///        restores it on its own.
+__attribute__((noinline)) bool copyOnly(Word_t *const Dst, const Word_t *,
+                                        const std::size_t NumWords) {
+  return NumWords != 0 && (Dst[0] & 1) != 0;
+}
+
+double measure(bool (*Kernel)(Word_t *, const Word_t *, std::size_t),
+               const std::vector<Word_t> &Init,
+               const std::vector<Word_t> &Src, const std::size_t NumBits) {
+  const std::size_t NumReps = BitsPerMeasurement / NumBits;
+  std::vector<Word_t> Dst(Init.size());
+  // Keep the results observable so that the loop cannot be optimized away.
+  std::size_t NumChanged = 0;
+
+  const auto Begin = std::chrono::steady_clock::now();
+  for (std::size_t Rep = 0; Rep < NumReps; ++Rep) {
+    std::copy(Init.begin(), Init.end(), Dst.begin());
+    NumChanged += Kernel(Dst.data(), Src.data(), Dst.size());
+  }
+  const auto End = std::chrono::steady_clock::now();
+
+  if (NumChanged == std::size_t(-1)) {
+    std::printf("unreachable\n");
+  }
+  return std::chrono::duration<double, std::nano>(End - Begin).count() /
+         static_cast<double>(NumReps);
+}
+
+} // anonymous namespace
+
+int main() {
+  std::mt19937_64 RNG(70);
+  const ISA ISAs[] = {ISA::Scalar, ISA::SSE2, ISA::AVX2};
+
+  std::printf("%10s %8s %14s %14s %14s\n", "bits", "isa", "and (ns/meet)",
+              "or (ns/meet)", "andnot (ns)");
+  for (std::size_t NumBits = 64; NumBits <= (std::size_t(1) << 20);
+       NumBits *= 4) {
+    const std::size_t NumWords = NumBits / 64;
+    std::vector<Word_t> Src(NumWords), Dst(NumWords);
+    for (std::size_t Idx = 0; Idx < NumWords; ++Idx) {
+      Src[Idx] = RNG();
+      Dst[Idx] = RNG();
+    }
+    const double CopyNs = measure(copyOnly, Dst, Src, NumBits);
+    for (const ISA Kind : ISAs) {
+      if (!isISASupported(Kind)) {
+        continue;
+      }
+      const MeetKernels &Kernels = getMeetKernels(Kind);
+      const double AndNs = measure(Kernels.And, Dst, Src, NumBits) - CopyNs;
+      const double OrNs = measure(Kernels.Or, Dst, Src, NumBits) - CopyNs;
+      const double AndNotNs =
+          measure(Kernels.AndNot, Dst, Src, NumBits) - CopyNs;
+      std::printf("%10zu %8s %14.2f %14.2f %14.2f\n", NumBits, getISAName(Kind),
+                  AndNs, OrNs, AndNotNs);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/APInt.h>
+
+namespace dfa {
+
+/// @brief Fold the integer binary operator @p Opcode over the constants
+///        @p LHS and @p RHS , which must have the same bit width.
+/// @return Whether the operation has a well-defined result, stored in @p Res .
+///         Shifts by at least the bit width, divisions by zero and signed
+///         division overflows are not folded.
+bool foldBinaryOp(const unsigned Opcode, const llvm::APInt &LHS,
+                  const llvm::APInt &RHS, llvm::APInt &Res);
+/// @brief Fold the integer cast @p Opcode (i.e., a truncation or an
+///        extension) of the constant @p Val to @p DestBitWidth bits.
+/// @return Whether @p Opcode is an integer cast, with the result in @p Res .
+bool foldIntCast(const unsigned Opcode, const llvm::APInt &Val,
+                 const unsigned DestBitWidth, llvm::APInt &Res);
+
+} // namespace dfa
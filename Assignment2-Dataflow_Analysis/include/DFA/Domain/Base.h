@@ -1,5 +1,7 @@
 #pragma once // NOLINT(llvm-header-guard)
 
+#include <llvm/ADT/SmallVector.h>
+
 #include <unordered_map>
 #include <vector>
 
@@ -12,6 +14,9 @@ template <typename TDerivedDomainElem> struct DomainBase {
   /// @param Val
   /// @return
   virtual bool contain(const llvm::Value *const Val) const = 0;
+  /// @brief Get all the values that the domain element contains.
+  /// @return
+  virtual llvm::SmallVector<const llvm::Value *, 2> getValues() const = 0;
   /// @brief Replace all the occurrences of the source value with the
   ///        destination value.
   /// @param SrcVal
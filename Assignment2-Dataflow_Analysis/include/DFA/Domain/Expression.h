@@ -3,6 +3,7 @@
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/ModuleSlotTracker.h>
 #include <llvm/IR/Value.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -35,12 +36,18 @@ struct Expression final : DomainBase<Expression> {
     return false;
   }
 
+  /// @brief Print the expression, reusing the slot numbering in @p MST .
+  void print(llvm::raw_ostream &Outs, llvm::ModuleSlotTracker &MST) const;
+
   bool contain(const llvm::Value *const Val) const final {
 
     /// @todo(CSCD70) Please complete this method.
 
     return LHS == Val || RHS == Val;
   }
+  llvm::SmallVector<const llvm::Value *, 2> getValues() const final {
+    return {LHS, RHS};
+  }
   Expression replaceValueWith(const llvm::Value *const SrcVal,
                               const llvm::Value *const DstVal) const final {
 
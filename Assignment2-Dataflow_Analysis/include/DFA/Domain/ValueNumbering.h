@@ -0,0 +1,87 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Value.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Utility.h"
+
+namespace dfa {
+
+/// @brief Hash-consed value numbering of the values of one function.
+///
+///        Two values get the same number when they are known to be equal:
+///        binary operators are keyed on their opcode and the numbers of their
+///        operands (sorted for commutative opcodes), integer constants are
+///        keyed on their type and value, and operators on constant operands
+///        or with an identity operand (e.g., `x + 0`) are folded. Everything
+///        else (arguments, loads, calls, ...) gets a fresh number.
+///
+///        The table never creates new IR, hence it can be built concurrently
+///        on different functions.
+class ValueNumbering {
+public:
+  using VN_t = unsigned;
+
+private:
+  struct ExprKey {
+    unsigned Opcode;
+    VN_t LHS, RHS;
+    bool operator==(const ExprKey &Other) const {
+      return Opcode == Other.Opcode && LHS == Other.LHS && RHS == Other.RHS;
+    }
+  };
+  struct ExprKeyHash {
+    size_t operator()(const ExprKey &Key) const {
+      size_t HashVal = 0;
+      hashCombine(&HashVal, Key.Opcode, Key.LHS, Key.RHS);
+      return HashVal;
+    }
+  };
+  /// @brief Integer constant that a value number stands for, if any.
+  struct ConstInfo {
+    bool IsConst = false;
+    const llvm::Type *Ty = nullptr;
+    /// @brief Zero-extended value, of at most 64 bits.
+    uint64_t Val = 0;
+  };
+
+  llvm::DenseMap<const llvm::Value *, VN_t> ValueNumbers;
+  std::unordered_map<ExprKey, VN_t, ExprKeyHash> ExprNumbers;
+  llvm::DenseMap<std::pair<const llvm::Type *, uint64_t>, VN_t> ConstNumbers;
+  std::vector<ConstInfo> ConstInfos;
+
+  VN_t createValueNumber() {
+    ConstInfos.emplace_back();
+    return ConstInfos.size() - 1;
+  }
+  VN_t getConstNumber(const llvm::Type *const Ty, const uint64_t Val);
+  VN_t numberBinaryOperator(const llvm::BinaryOperator &BO);
+  VN_t numberPHINode(const llvm::PHINode &PHI);
+
+public:
+  /// @brief Number all the instructions of @p F . The blocks are visited in
+  ///        reverse post-order, so that the operands are (apart from the
+  ///        incoming values of PHIs) numbered before their users. The
+  ///        instructions of unreachable blocks are left opaque.
+  void numberFunction(const llvm::Function &F);
+  void clear();
+
+  /// @brief Get the value number of @p Val , assigning one if needed.
+  VN_t getValueNumber(const llvm::Value *const Val);
+  /// @brief Check whether @p VN stands for an integer constant.
+  bool isConst(const VN_t VN) const { return ConstInfos[VN].IsConst; }
+  /// @brief Get the (zero-extended) integer constant that @p VN stands for.
+  uint64_t getConst(const VN_t VN) const {
+    CHECK(isConst(VN)) << "Value number " << VN << " is not a constant";
+    return ConstInfos[VN].Val;
+  }
+  size_t getNumValueNumbers() const { return ConstInfos.size(); }
+};
+
+} // namespace dfa
@@ -3,6 +3,7 @@
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/ModuleSlotTracker.h>
 #include <llvm/IR/Value.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -17,12 +18,18 @@ struct Variable final : DomainBase<Variable> {
 
   bool operator==(const Variable &Other) const { return Var == Other.Var; }
 
+  /// @brief Print the variable, reusing the slot numbering in @p MST .
+  void print(llvm::raw_ostream &Outs, llvm::ModuleSlotTracker &MST) const;
+
   bool contain(const llvm::Value *const Val) const final {
 
     /// @todo(CSCD70) Please complete this method.
 
     return this->Var == Val;
   }
+  llvm::SmallVector<const llvm::Value *, 2> getValues() const final {
+    return {Var};
+  }
   Variable replaceValueWith(const llvm::Value *const SrcVal,
                             const llvm::Value *const DstVal) const final {
 
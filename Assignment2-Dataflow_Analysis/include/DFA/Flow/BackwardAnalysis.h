@@ -6,6 +6,8 @@
 #include <llvm/IR/Instruction.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <unordered_set>
+
 /// @todo(CSCD70) Please instantiate for the backward pass, similar to the
 ///               forward one.
 /// @sa @c ForwardAnalysis
@@ -15,8 +17,10 @@ namespace dfa {
 
 typedef llvm::iterator_range<llvm::const_succ_iterator>
     BackwardMeetBBConstRange_t;
+typedef llvm::iterator_range<llvm::const_pred_iterator>
+    BackwardDependentBBConstRange_t;
 typedef llvm::iterator_range<
-    llvm::Function::BasicBlockListType::const_reverse_iterator>
+    std::vector<const llvm::BasicBlock *>::const_iterator>
     BackwardBBConstRange_t;
 typedef llvm::iterator_range<
     llvm::BasicBlock::InstListType::const_reverse_iterator>
@@ -25,50 +29,87 @@ typedef llvm::iterator_range<
 template <typename TDomainElem, typename TValue, typename TMeetOp>
 class BackwardAnalysis
     : public Framework<TDomainElem, TValue, TMeetOp, BackwardMeetBBConstRange_t,
+                       BackwardDependentBBConstRange_t,
                        BackwardBBConstRange_t, BackwardInstConstRange_t> {
 protected:
   using Framework_t =
       Framework<TDomainElem, TValue, TMeetOp, BackwardMeetBBConstRange_t,
+                BackwardDependentBBConstRange_t,
                 BackwardBBConstRange_t, BackwardInstConstRange_t>;
-  using typename Framework_t::AnalysisResult_t;
   using typename Framework_t::BBConstRange_t;
+  using typename Framework_t::DependentBBConstRange_t;
+  using typename Framework_t::DomainVal_t;
   using typename Framework_t::InstConstRange_t;
   using typename Framework_t::MeetBBConstRange_t;
 
+  using Framework_t::BBOrder;
   using Framework_t::BVs;
   using Framework_t::DomainIdMap;
   using Framework_t::DomainVector;
-  using Framework_t::InstDomainValMap;
+  using Framework_t::InstIdx;
+  using Framework_t::materializeBB;
+
+  using typename Framework_t::DumpStream;
+  using Framework_t::printDomainWithMask;
+  using Framework_t::printInst;
 
-  using Framework_t::getBoundaryVal;
-  using Framework_t::getName;
-  using Framework_t::run;
-  using Framework_t::stringifyDomainWithMask;
+public:
+  // Result queries, which have to stay public for AnalysisResult.
+  using Framework_t::getExitVal;
+  using Framework_t::getOut;
 
-  void printInstDomainValMap(const llvm::Instruction &Inst) const final {
-    using llvm::errs;
-    using llvm::outs;
-    const llvm::BasicBlock *const ParentBB = Inst.getParent();
+protected:
 
-    outs() << Inst << "\n";
-    LOG_ANALYSIS_INFO << "\t"
-                      << stringifyDomainWithMask(InstDomainValMap.at(&Inst));
-    if (&Inst == &(ParentBB->back())) {
-      errs() << "\n";
-      LOG_ANALYSIS_INFO << "\t"
-                        << stringifyDomainWithMask(getBoundaryVal(*ParentBB));
-    } // if (&Inst == &(*ParentBB->back()))
+  void printBBDomainVals(const llvm::BasicBlock &BB, DumpStream &DS,
+                         const bool PrintInsts) final {
+    if (PrintInsts) {
+      const std::vector<DomainVal_t> &InstVals = materializeBB(BB);
+      for (const llvm::Instruction &Inst : BB) {
+        printInst(DS, Inst);
+        printDomainWithMask(DS, InstVals[InstIdx.at(&Inst)]);
+      }
+    } else {
+      printDomainWithMask(DS, getExitVal(BB));
+    }
+    DS.Errs << "\n";
+    printDomainWithMask(DS, BVs.at(&BB));
   }
 
   MeetBBConstRange_t
   getMeetBBConstRange(const llvm::BasicBlock &BB) const final {
     return llvm::successors(&BB);
   }
+  DependentBBConstRange_t
+  getDependentBBConstRange(const llvm::BasicBlock &BB) const final {
+    return llvm::predecessors(&BB);
+  }
   InstConstRange_t getInstConstRange(const llvm::BasicBlock &BB) const final {
     return make_range(BB.rbegin(), BB.rend());
   }
+  /// @brief Visit the blocks in the reverse of the forward order, i.e., in
+  ///        post-order from the entry with the strongly-connected components
+  ///        kept contiguous, so that every block (except for the sources of
+  ///        back edges) is visited after all its successors. This is not the
+  ///        reverse post-order of the reverse CFG, which starts from the exits
+  ///        and differs from it when some blocks cannot reach an exit. Blocks
+  ///        that are unreachable from the entry are appended at the end in
+  ///        reverse layout order.
+  /// @sa @c getSCCOrderedRPO
+  void initializeBBOrder(const llvm::Function &F) final {
+    BBOrder = Framework_t::getSCCOrderedRPO(F);
+    std::reverse(BBOrder.begin(), BBOrder.end());
+    if (BBOrder.size() != F.size()) {
+      std::unordered_set<const llvm::BasicBlock *> Visited(BBOrder.begin(),
+                                                          BBOrder.end());
+      for (const llvm::BasicBlock &BB : llvm::reverse(F)) {
+        if (!Visited.count(&BB)) {
+          BBOrder.push_back(&BB);
+        }
+      }
+    }
+  }
   BBConstRange_t getBBConstRange(const llvm::Function &F) const final {
-    return make_range(F.end(), F.begin());
+    return make_range(BBOrder.begin(), BBOrder.end());
   }
 };
 
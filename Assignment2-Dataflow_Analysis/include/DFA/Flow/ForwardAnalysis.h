@@ -2,13 +2,18 @@
 
 #include "Framework.h"
 
+#include <unordered_set>
+
 namespace dfa {
 
 /// @todo(CSCD70) Please modify the traversal ranges.
 
 typedef llvm::iterator_range<llvm::const_pred_iterator>
     ForwardMeetBBConstRange_t;
-typedef llvm::iterator_range<llvm::Function::const_iterator>
+typedef llvm::iterator_range<llvm::const_succ_iterator>
+    ForwardDependentBBConstRange_t;
+typedef llvm::iterator_range<
+    std::vector<const llvm::BasicBlock *>::const_iterator>
     ForwardBBConstRange_t;
 typedef llvm::iterator_range<llvm::BasicBlock::const_iterator>
     ForwardInstConstRange_t;
@@ -16,49 +21,82 @@ typedef llvm::iterator_range<llvm::BasicBlock::const_iterator>
 template <typename TDomainElem, typename TValue, typename TMeetOp>
 class ForwardAnalysis
     : public Framework<TDomainElem, TValue, TMeetOp, ForwardMeetBBConstRange_t,
+                       ForwardDependentBBConstRange_t,
                        ForwardBBConstRange_t, ForwardInstConstRange_t> {
 protected:
   using Framework_t =
       Framework<TDomainElem, TValue, TMeetOp, ForwardMeetBBConstRange_t,
+                ForwardDependentBBConstRange_t,
                 ForwardBBConstRange_t, ForwardInstConstRange_t>;
-  using typename Framework_t::AnalysisResult_t;
   using typename Framework_t::BBConstRange_t;
+  using typename Framework_t::DependentBBConstRange_t;
+  using typename Framework_t::DomainVal_t;
   using typename Framework_t::InstConstRange_t;
   using typename Framework_t::MeetBBConstRange_t;
 
+  using Framework_t::BBOrder;
   using Framework_t::BVs;
   using Framework_t::DomainIdMap;
   using Framework_t::DomainVector;
-  using Framework_t::InstDomainValMap;
+  using Framework_t::InstIdx;
+  using Framework_t::materializeBB;
+
+  using typename Framework_t::DumpStream;
+  using Framework_t::printDomainWithMask;
+  using Framework_t::printInst;
 
-  using Framework_t::getName;
-  using Framework_t::run;
-  using Framework_t::stringifyDomainWithMask;
+public:
+  // Result queries, which have to stay public for AnalysisResult.
+  using Framework_t::getExitVal;
+  using Framework_t::getOut;
 
-  void printInstDomainValMap(const llvm::Instruction &Inst) const final {
-    using llvm::errs;
-    using llvm::outs;
-    const llvm::BasicBlock *const ParentBB = Inst.getParent();
-    
+protected:
 
-    if (&Inst == &(ParentBB->front())) {
-      errs() << "\n";
-      LOG_ANALYSIS_INFO << "\t" << stringifyDomainWithMask(BVs.at(ParentBB));
-    } // if (&Inst == &(*ParentBB->begin()))
-    outs() << Inst << "\n";
-    LOG_ANALYSIS_INFO << "\t"
-                      << stringifyDomainWithMask(InstDomainValMap.at(&Inst));
+  void printBBDomainVals(const llvm::BasicBlock &BB, DumpStream &DS,
+                         const bool PrintInsts) final {
+    DS.Errs << "\n";
+    printDomainWithMask(DS, BVs.at(&BB));
+    if (!PrintInsts) {
+      printDomainWithMask(DS, getExitVal(BB));
+      return;
+    }
+    const std::vector<DomainVal_t> &InstVals = materializeBB(BB);
+    for (const llvm::Instruction &Inst : BB) {
+      printInst(DS, Inst);
+      printDomainWithMask(DS, InstVals[InstIdx.at(&Inst)]);
+    }
   }
 
   MeetBBConstRange_t
   getMeetBBConstRange(const llvm::BasicBlock &BB) const final {
     return llvm::predecessors(&BB);
   }
+  DependentBBConstRange_t
+  getDependentBBConstRange(const llvm::BasicBlock &BB) const final {
+    return llvm::successors(&BB);
+  }
   InstConstRange_t getInstConstRange(const llvm::BasicBlock &BB) const final {
     return make_range(BB.begin(), BB.end());
   }
+  /// @brief Visit the blocks in reverse post-order, so that every block
+  ///        (except for loop headers) is visited after all its predecessors.
+  ///        Blocks that are unreachable from the entry are appended at the
+  ///        end in layout order.
+  /// @sa @c getSCCOrderedRPO
+  void initializeBBOrder(const llvm::Function &F) final {
+    BBOrder = Framework_t::getSCCOrderedRPO(F);
+    if (BBOrder.size() != F.size()) {
+      std::unordered_set<const llvm::BasicBlock *> Visited(BBOrder.begin(),
+                                                          BBOrder.end());
+      for (const llvm::BasicBlock &BB : F) {
+        if (!Visited.count(&BB)) {
+          BBOrder.push_back(&BB);
+        }
+      }
+    }
+  }
   BBConstRange_t getBBConstRange(const llvm::Function &F) const final {
-    return make_range(F.begin(), F.end());
+    return make_range(BBOrder.begin(), BBOrder.end());
   }
 };
 
@@ -1,69 +1,169 @@
 #pragma once // NOLINT(llvm-header-guard)
 
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/ConstantRange.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/IR/InstVisitor.h>
-#include <tuple>
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/Support/CommandLine.h>
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Utility.h"
 
 namespace dfa {
 
+/// @brief Strategy used by @c Framework::run to reach the fixpoint.
+enum class SolverKind {
+  Sweep,   ///< Re-traverse the whole CFG until nothing changes.
+  Worklist ///< Only re-traverse blocks whose meet inputs have changed.
+};
+
+/// @brief Amount of diagnostics printed by @c Framework::print .
+enum class Verbosity {
+  None,    ///< Print nothing.
+  Summary, ///< Only print the number of visits until convergence.
+  Block,   ///< Also print the domain values at the block boundaries.
+  Full     ///< Also print the domain value after every instruction.
+};
+
+extern llvm::cl::opt<SolverKind> Solver;
+extern llvm::cl::opt<unsigned> InstValCacheSize;
+extern llvm::cl::opt<Verbosity> DumpVerbosity;
+extern llvm::cl::opt<unsigned> WideningDelay;
+extern llvm::cl::opt<unsigned> NarrowingPasses;
+
 template <typename TValue> struct ValuePrinter {
-  static std::string print(const TValue &V) { return ""; }
+  template <typename TElem>
+  static void print(llvm::raw_ostream &, const TElem &) {}
 };
 
 
 template <typename TDomainElem, typename TValue, typename TMeetOp,
-          typename TMeetBBConstRange, typename TBBConstRange,
-          typename TInstConstRange>
+          typename TMeetBBConstRange, typename TDependentBBConstRange,
+          typename TBBConstRange, typename TInstConstRange>
 class Framework {
-protected:
+public:
+  static constexpr size_t NoDomainId = static_cast<size_t>(-1);
+
   using DomainIdMap_t = typename TDomainElem::DomainIdMap_t;
   using DomainVector_t = typename TDomainElem::DomainVector_t;
   using DomainVal_t = typename TMeetOp::DomainVal_t;
-  using MeetOperands_t = std::vector<DomainVal_t>;
   using MeetBBConstRange_t = TMeetBBConstRange;
+  using DependentBBConstRange_t = TDependentBBConstRange;
   using BBConstRange_t = TBBConstRange;
   using InstConstRange_t = TInstConstRange;
-  using AnalysisResult_t =
-      std::tuple<DomainIdMap_t, DomainVector_t,
-                 std::unordered_map<const llvm::BasicBlock *, DomainVal_t>,
-                 std::unordered_map<const llvm::Instruction *, DomainVal_t>>;
+  using BBDomainValMap_t =
+      std::unordered_map<const llvm::BasicBlock *, DomainVal_t>;
 
+protected:
   DomainIdMap_t DomainIdMap;
   DomainVector_t DomainVector;
-  std::unordered_map<const llvm::BasicBlock *, DomainVal_t> BVs;
-  std::unordered_map<const llvm::Instruction *, DomainVal_t> InstDomainValMap;
+  /// @brief Domain id associated with each value of the function (e.g., the
+  ///        variable itself or the expression computed by an instruction), so
+  ///        that the transfer functions do not have to hash domain elements.
+  llvm::DenseMap<const llvm::Value *, size_t> ValueDomainIds;
+  /// @brief Domain value at the entry of every basic block (in traversal
+  ///        order).
+  BBDomainValMap_t BVs;
+  /// @brief Domain value at the exit of every basic block (in traversal
+  ///        order), i.e., the value that its dependent blocks meet over.
+  BBDomainValMap_t BBExitVals;
+  /// @brief Position of every instruction within its basic block, in
+  ///        traversal order.
+  std::unordered_map<const llvm::Instruction *, size_t> InstIdx;
+  /// @brief Least-recently-used cache of the per-instruction domain values
+  ///        of a few basic blocks. Each entry holds the output value of every
+  ///        instruction of the block, indexed by @c InstIdx .
+  std::list<std::pair<const llvm::BasicBlock *, std::vector<DomainVal_t>>>
+      InstValCache;
+  /// @brief Traversal order of the basic blocks, cached once per function.
+  std::vector<const llvm::BasicBlock *> BBOrder;
+  std::unordered_map<const llvm::BasicBlock *, size_t> BBOrderIdx;
+  /// @brief Block that is the target of a retreating edge in @c BBOrder ,
+  ///        at whose entry the values are widened.
+  struct WideningPoint {
+    /// @brief Entry value as of the last visit.
+    DomainVal_t Prev;
+    /// @brief Number of visits that only apply the meet operator before the
+    ///        widening starts, i.e., the iteration budget of the block.
+    unsigned Delay;
+  };
+  /// @brief Widening points of the function. Only populated if the meet
+  ///        operator has widening.
+  std::unordered_map<const llvm::BasicBlock *, WideningPoint> WideningPoints;
+  /// @brief Whether the solver is running the descending iterations, which
+  ///        narrow (rather than widen) the values at the widening points.
+  bool IsNarrowing = false;
+  /// @brief Number of visits of every block in the last run, indexed by
+  ///        @c BBOrderIdx .
+  std::vector<size_t> BBVisitCounts;
+  /// @brief Number of basic blocks visited by the solver in the last run.
+  size_t NumBBVisits = 0;
+
+  TMeetOp MeetOp;
+  /// @brief Boundary condition, i.e., the value at the entry (exit) of the
+  ///        function for forward (backward) analyses.
+  DomainVal_t BCVal;
+  /// @brief Preallocated buffers for the block entry values, the transfer
+  ///        function outputs and the intermediate values within a block. All
+  ///        of them are sized once per run and then reused, so that the
+  ///        fixpoint loop does not allocate.
+  DomainVal_t BoundaryBuf, TransferBuf, InstBufs[2];
 
   /// @name Print utility functions
   /// @{
 
-  std::string stringifyDomainWithMask(const DomainVal_t &Mask) const {
-    std::string StringBuf;
-    llvm::raw_string_ostream Strout(StringBuf);
-    Strout << "{";
+  /// @brief Destination of the dump. The instructions go to @c Outs and the
+  ///        domain values to @c Errs , in the format of @c LOG_ANALYSIS_INFO .
+  struct DumpStream {
+    llvm::raw_ostream &Outs, &Errs;
+    /// @brief Slot numbering of the function, computed once per dump.
+    llvm::ModuleSlotTracker &MST;
+    const std::string Prefix;
+  };
+
+  void printDomainWithMask(DumpStream &DS, const DomainVal_t &Mask) const {
     CHECK(Mask.size() == DomainIdMap.size() &&
           Mask.size() == DomainVector.size())
         << "The size of mask must be equal to the size of domain, but got "
         << Mask.size() << " vs. " << DomainIdMap.size() << " vs. "
         << DomainVector.size() << " instead";
+    DS.Errs << DS.Prefix << "\t{";
     for (size_t DomainId = 0; DomainId < DomainIdMap.size(); ++DomainId) {
       if (static_cast<bool>(Mask[DomainId])) {
-      Strout << DomainVector.at(DomainId)
-             << ValuePrinter<TValue>::print(Mask[DomainId]) << ", ";
+        DomainVector[DomainId].print(DS.Errs, DS.MST);
+        ValuePrinter<TValue>::print(DS.Errs, Mask[DomainId]);
+        DS.Errs << ", ";
       }
-
-   } // for (MaskIdx : [0, Mask.size()))
-    Strout << "}";
-    return StringBuf;
+    } // for (MaskIdx : [0, Mask.size()))
+    DS.Errs << "}\n";
   }
-  virtual void printInstDomainValMap(const llvm::Instruction &Inst) const = 0;
-  void printInstDomainValMap(const llvm::Function &F) const {
-    for (const llvm::Instruction &Inst : llvm::instructions(&F)) {
-      printInstDomainValMap(Inst);
-    }
+  void printInst(DumpStream &DS, const llvm::Instruction &Inst) const {
+    Inst.print(DS.Outs, DS.MST);
+    DS.Outs << "\n";
   }
+  /// @brief Print the domain values of the basic block, at its boundaries
+  ///        and, if @p PrintInsts is set, after each of its instructions.
+  virtual void printBBDomainVals(const llvm::BasicBlock &BB, DumpStream &DS,
+                                 const bool PrintInsts) = 0;
 
   virtual std::string getName() const = 0;
 
@@ -72,14 +172,30 @@ protected:
   /// @{
 
   DomainVal_t getBoundaryVal(const llvm::BasicBlock &BB) const {
-    MeetOperands_t MeetOperands = getMeetOperands(BB);
-
-    /// @todo(CSCD70) Please complete this method.
-    if(MeetOperands.begin() == MeetOperands.end()){
-      return DomainVal_t(DomainIdMap.size());
+    DomainVal_t BoundaryVal = bc();
+    computeBoundaryVal(BB, BoundaryVal);
+    return BoundaryVal;
+  }
+  /// @brief Compute the boundary value of @p BB in place, by meeting the exit
+  ///        values of its meet operands directly into @p BoundaryVal .
+  /// @param BB
+  /// @param BoundaryVal  Preallocated buffer of the same size as the domain.
+  void computeBoundaryVal(const llvm::BasicBlock &BB,
+                          DomainVal_t &BoundaryVal) const {
+    bool IsFirst = true;
+
+    for (const llvm::BasicBlock *const MeetBB : getMeetBBConstRange(BB)) {
+      const DomainVal_t &ExitVal = BBExitVals.at(MeetBB);
+      if (IsFirst) {
+        BoundaryVal = ExitVal;
+        IsFirst = false;
+      } else {
+        MeetOp.meetInto(BoundaryVal, ExitVal);
+      }
+    }
+    if (IsFirst) {
+      BoundaryVal = BCVal;
     }
-
-    return meet(MeetOperands);
   }
   /// @brief Get the list of basic blocks to which the meet operator will be
   ///        applied.
@@ -87,71 +203,186 @@ protected:
   /// @return
   virtual MeetBBConstRange_t
   getMeetBBConstRange(const llvm::BasicBlock &BB) const = 0;
-  /// @brief Get the list of domain values to which the meet operator will be
-  ///        applied.
+  /// @brief Get the list of basic blocks whose meet operands include @p BB ,
+  ///        i.e., the ones that have to be revisited once @p BB changes.
   /// @param BB
   /// @return
   /// @sa @c getMeetBBConstRange
-  virtual MeetOperands_t getMeetOperands(const llvm::BasicBlock &BB) const {
-    MeetOperands_t Operands;
-
-    /// @todo(CSCD70) Please complete this method.
-    MeetBBConstRange_t MeetBB = getMeetBBConstRange(BB);
-    for(const auto &B : MeetBB){
-      // 获得该BB最后一个Inst的output
-      auto IList = getInstConstRange(*B);
-      const llvm::Instruction &I = *std::prev(IList.end());
-      Operands.push_back(InstDomainValMap.at(&I));
-    }
-
-    return Operands;
+  virtual DependentBBConstRange_t
+  getDependentBBConstRange(const llvm::BasicBlock &BB) const = 0;
+  /// @brief Get the last instruction of @p BB in traversal order, whose
+  ///        domain value is the one seen by the dependent blocks.
+  /// @param BB
+  /// @return
+  const llvm::Instruction &getExitInst(const llvm::BasicBlock &BB) const {
+    return *std::prev(getInstConstRange(BB).end());
   }
   DomainVal_t bc() const { return DomainVal_t(DomainIdMap.size()); }
-  DomainVal_t meet(const MeetOperands_t &MeetOperands) const {
-
-    /// @todo(CSCD70) Please complete this method.
-    TMeetOp MeetOp;
-    DomainVal_t result = MeetOp.top(DomainVector.size());
-    for(auto &meetVal : MeetOperands)
-      result = MeetOp(result, meetVal);
-
-    return result;
-  }
 
   /// @}
   /// @name CFG traversal
   /// @{
 
+  /// @brief Get the basic blocks reachable from the entry in reverse
+  ///        post-order, rearranged so that each strongly-connected component
+  ///        (i.e., each outermost loop) is contiguous. Components follow a
+  ///        topological order of the condensed CFG.
+  ///
+  ///        Plain reverse post-order may place the body of a loop after the
+  ///        blocks following its exit, in which case every iteration of the
+  ///        loop would be propagated through the rest of the function before
+  ///        the loop itself stabilizes.
+  /// @param F
+  /// @return
+  static std::vector<const llvm::BasicBlock *>
+  getSCCOrderedRPO(const llvm::Function &F) {
+    std::unordered_map<const llvm::BasicBlock *, size_t> RPOIdx;
+    for (const llvm::BasicBlock *const BB :
+         llvm::ReversePostOrderTraversal<const llvm::Function *>(&F)) {
+      RPOIdx.emplace(BB, RPOIdx.size());
+    }
+    // scc_iterator enumerates the components in reverse topological order.
+    std::vector<std::vector<const llvm::BasicBlock *>> SCCs;
+    for (auto SCCIt = llvm::scc_begin(&F); !SCCIt.isAtEnd(); ++SCCIt) {
+      SCCs.push_back(*SCCIt);
+    }
+    std::vector<const llvm::BasicBlock *> Order;
+    Order.reserve(RPOIdx.size());
+    for (auto SCCIt = SCCs.rbegin(); SCCIt != SCCs.rend(); ++SCCIt) {
+      std::sort(SCCIt->begin(), SCCIt->end(),
+                [&RPOIdx](const llvm::BasicBlock *const LHS,
+                          const llvm::BasicBlock *const RHS) {
+                  return RPOIdx.at(LHS) < RPOIdx.at(RHS);
+                });
+      Order.insert(Order.end(), SCCIt->begin(), SCCIt->end());
+    }
+    return Order;
+  }
+  /// @brief Find the widening points of the function, if the meet operator
+  ///        has widening. Every cycle of the CFG contains an edge that goes
+  ///        backward in @c BBOrder , hence widening at the targets of such
+  ///        edges is enough for the fixpoint iteration to terminate.
+  ///
+  ///        The headers of natural loops (as found by @c llvm::LoopInfo ) get
+  ///        an iteration budget of @c WideningDelay visits before the
+  ///        widening starts, so that short loops keep precise values. The
+  ///        other targets (e.g., the entries of irreducible cycles) are
+  ///        widened right away.
+  /// @param F
+  void initializeWideningPoints(const llvm::Function &F) {
+    WideningPoints.clear();
+    if (!MeetOp.hasWidening()) {
+      return;
+    }
+    // The dominator tree only reads the CFG.
+    llvm::DominatorTree DT(const_cast<llvm::Function &>(F));
+    llvm::LoopInfo LI(DT);
+    for (const llvm::BasicBlock *const BB : BBOrder) {
+      for (const llvm::BasicBlock *const MeetBB : getMeetBBConstRange(*BB)) {
+        if (BBOrderIdx.at(MeetBB) >= BBOrderIdx.at(BB)) {
+          WideningPoints.emplace(
+              BB, WideningPoint{.Prev = MeetOp.top(DomainVector.size()),
+                                .Delay = LI.isLoopHeader(BB)
+                                             ? WideningDelay.getValue()
+                                             : 0U});
+          break;
+        }
+      }
+    }
+  }
+  /// @brief Compute the order in which the basic blocks of the function are
+  ///        to be traversed and store it in @c BBOrder .
+  /// @param F
+  virtual void initializeBBOrder(const llvm::Function &F) = 0;
   /// @brief Get the list of basic blocks from the function.
   /// @param F
   /// @return
+  /// @sa @c initializeBBOrder
   virtual BBConstRange_t getBBConstRange(const llvm::Function &F) const = 0;
   /// @brief Get the list of instructions from the basic block.
   /// @param BB
   /// @return
   virtual InstConstRange_t
   getInstConstRange(const llvm::BasicBlock &BB) const = 0;
+  /// @brief Apply the transfer function of the whole basic block. By default
+  ///        the transfer function of every instruction is applied in turn.
+  /// @param BB
+  /// @param IBV  Domain value at the entry of the block (in traversal order).
+  /// @param OBV  Domain value at the exit of the block (in traversal order).
+  /// @return Whether @p OBV has been changed.
+  virtual bool transferBB(const llvm::BasicBlock &BB, const DomainVal_t &IBV,
+                          DomainVal_t &OBV) {
+    const DomainVal_t *Input = &IBV;
+    size_t BufIdx = 0;
+    for (const auto &I : getInstConstRange(BB)) {
+      transferFunc(I, *Input, InstBufs[BufIdx]);
+      Input = &InstBufs[BufIdx];
+      BufIdx ^= 1;
+    }
+    if (*Input != OBV) {
+      OBV = *Input;
+      return true;
+    }
+    return false;
+  }
+  /// @brief Recompute the exit value of the basic block from its meet
+  ///        operands.
+  /// @param BB
+  /// @return True if the domain value at the exit of the block (in traversal
+  ///         order) has been modified, false otherwise.
+  bool traverseBB(const llvm::BasicBlock &BB) {
+    computeBoundaryVal(BB, BoundaryBuf);
+    const size_t NumVisits = ++BBVisitCounts[BBOrderIdx.at(&BB)];
+    const auto WideningIt = WideningPoints.find(&BB);
+    if (WideningIt != WideningPoints.end()) {
+      WideningPoint &Point = WideningIt->second;
+      if (IsNarrowing) {
+        MeetOp.narrowInto(BoundaryBuf, Point.Prev);
+      } else if (NumVisits > Point.Delay) {
+        MeetOp.widenInto(BoundaryBuf, Point.Prev);
+      }
+      Point.Prev = BoundaryBuf;
+    }
+    ++NumBBVisits;
+    return transferBB(BB, BoundaryBuf, BBExitVals.at(&BB));
+  }
   /// @brief Traverse through the CFG of the function.
   /// @param F
-  /// @return True if either BasicBlock-DomainValue mapping or
-  ///         Instruction-DomainValue mapping has been modified, false
-  ///         otherwise.
-  /// 
+  /// @return True if the exit domain value of any basic block has been
+  ///         modified, false otherwise.
   bool traverseCFG(const llvm::Function &F) {
     bool Changed = false;
 
     /// @todo(CSCD70) Please complete this method.
-    BBConstRange_t BBList = getBBConstRange(F);
-    for(const auto &BB : BBList){
-      DomainVal_t input = getBoundaryVal(BB);
-      for(const auto &I : getInstConstRange(BB)){
-          Changed |= transferFunc(I, input, InstDomainValMap.at(&I)); // error: out of boundary
-          input = InstDomainValMap.at(&I);
-      }
+    for (const llvm::BasicBlock *const BB : getBBConstRange(F)) {
+      Changed |= traverseBB(*BB);
     }
 
     return Changed;
   }
+  /// @brief Reach the fixpoint using a worklist of basic blocks. A block is
+  ///        only revisited when the exit value of one of its meet operands
+  ///        has changed. Pending blocks are always popped in traversal order.
+  /// @param F
+  void solveWorklist(const llvm::Function &F) {
+    std::set<size_t> Worklist;
+
+    for (size_t Idx = 0; Idx < BBOrder.size(); ++Idx) {
+      Worklist.insert(Idx);
+    }
+    while (!Worklist.empty()) {
+      const llvm::BasicBlock *const BB = BBOrder[*Worklist.begin()];
+      Worklist.erase(Worklist.begin());
+
+      if (!traverseBB(*BB)) {
+        continue;
+      }
+      for (const llvm::BasicBlock *const DepBB :
+           getDependentBBConstRange(*BB)) {
+        Worklist.insert(BBOrderIdx.at(DepBB));
+      }
+    } // while (!Worklist.empty())
+  }
 
   /// @}
 
@@ -159,49 +390,360 @@ protected:
 
   /// @brief Apply the transfer function to the input domain value at
   ///        instruction @p inst .
+  ///
+  ///        Implementations are expected to build the new output in
+  ///        @c TransferBuf (e.g., starting with `TransferBuf = IDV`, which
+  ///        reuses its storage) and finish with `return updateODV(ODV)`.
   /// @param Inst
   /// @param IDV
   /// @param ODV
   /// @return Whether the output domain value is to be changed.
   virtual bool transferFunc(const llvm::Instruction &Inst,
                             const DomainVal_t &IDV, DomainVal_t &ODV) = 0;
+  /// @brief Replace @p ODV with the content of @c TransferBuf if they differ.
+  ///        The two buffers are swapped rather than copied, so neither of
+  ///        them gets reallocated.
+  /// @param ODV
+  /// @return Whether @p ODV has been changed.
+  bool updateODV(DomainVal_t &ODV) {
+    if (TransferBuf != ODV) {
+      std::swap(TransferBuf, ODV);
+      return true;
+    }
+    return false;
+  }
 
   virtual void initializeDomainFromInst(const llvm::Instruction &Inst) = 0;
+  /// @brief Build the domain of the function, by default one instruction at a
+  ///        time in layout order.
+  virtual void initializeDomain(const llvm::Function &F) {
+    for (const llvm::Instruction &Inst : llvm::instructions(&F)) {
+      initializeDomainFromInst(Inst);
+    }
+  }
 
-  virtual AnalysisResult_t run(llvm::Function &F,
-                               llvm::FunctionAnalysisManager &FAM) {
+  /// @name Domain ids
+  /// @{
 
-    /// @todo(CSCD70) Please complete this method.
-    //dfa::Expression::Initializer visitor(DomainIdMap, DomainVector);
-    //dfa::Variable::Initializer visitor(DomainIdMap, DomainVector);
-    TMeetOp MeetOp;
-    for(auto &BB : F){
-      for(auto &I : BB){
-        initializeDomainFromInst(I);      
+  /// @brief Add @p Elem to the domain unless it is already there, and
+  ///        associate its id with @p Val .
+  /// @param Elem
+  /// @param Val
+  /// @return The id of @p Elem .
+  size_t internDomainElem(const TDomainElem &Elem,
+                          const llvm::Value *const Val) {
+    const auto Iter = DomainIdMap.emplace(Elem, DomainVector.size()).first;
+    if (Iter->second == DomainVector.size()) {
+      DomainVector.push_back(Elem);
+    }
+    ValueDomainIds.try_emplace(Val, Iter->second);
+    return Iter->second;
+  }
+
+  /// @brief Domain ids touched by the transfer function of an instruction,
+  ///        precomputed once per function so that the transfer functions do
+  ///        not have to search the domain.
+  struct InstDomainIds {
+    /// @brief Id associated with the instruction itself, i.e., the variable
+    ///        that it defines or the expression that it computes.
+    size_t Def = NoDomainId;
+    /// @brief Id associated with each operand (in operand order), or
+    ///        @c NoDomainId for operands that are not part of the domain.
+    llvm::SmallVector<size_t, 2> Uses;
+    /// @brief Ids of the elements that are invalidated by the instruction,
+    ///        i.e., by default those that contain the value it defines.
+    llvm::SmallVector<size_t, 2> Kills;
+  };
+  std::vector<InstDomainIds> InstIds;
+  /// @brief Dense number of every instruction, used to index @c InstIds .
+  llvm::DenseMap<const llvm::Instruction *, size_t> InstNums;
+
+  /// @brief Ids of the domain elements that contain each value.
+  using ContainingIds_t =
+      llvm::DenseMap<const llvm::Value *, llvm::SmallVector<size_t, 2>>;
+
+  /// @brief Fill the domain ids of @p Inst . Instructions are visited in
+  ///        layout order.
+  virtual void initializeInstDomainIds(const llvm::Instruction &Inst,
+                                       const ContainingIds_t &ContainingIds,
+                                       InstDomainIds &Ids) {
+    Ids.Def = getDomainId(&Inst);
+    for (const llvm::Use &Op : Inst.operands()) {
+      Ids.Uses.push_back(getDomainId(Op));
+    }
+    const auto Iter = ContainingIds.find(&Inst);
+    if (Iter != ContainingIds.end()) {
+      Ids.Kills = Iter->second;
+    }
+  }
+  virtual void initializeInstDomainIds(const llvm::Function &F) {
+    ContainingIds_t ContainingIds;
+    for (size_t DomainId = 0; DomainId < DomainVector.size(); ++DomainId) {
+      for (const llvm::Value *const Val : DomainVector[DomainId].getValues()) {
+        ContainingIds[Val].push_back(DomainId);
       }
     }
+    InstIds.clear();
+    InstNums.clear();
+    for (const llvm::Instruction &Inst : llvm::instructions(&F)) {
+      InstNums.try_emplace(&Inst, InstIds.size());
+      InstIds.emplace_back();
+      initializeInstDomainIds(Inst, ContainingIds, InstIds.back());
+    }
+  }
+  const InstDomainIds &getInstDomainIds(const llvm::Instruction &Inst) const {
+    return InstIds[InstNums.find(&Inst)->second];
+  }
 
+  /// @}
+
+  /// @name Per-instruction domain values
+  /// @{
 
-    for(auto &BB : F){
-      for(auto &I : BB){
-          InstDomainValMap.emplace(&I, MeetOp.top(DomainVector.size()));
+  /// @brief Summarize the transfer functions of the basic blocks before the
+  ///        fixpoint iteration starts.
+  /// @param F
+  /// @return True if @c transferBB no longer goes through the individual
+  ///         instructions.
+  virtual bool summarizeBBs(const llvm::Function &F) { return false; }
+  /// @brief Get the output value of every instruction of @p BB , replaying
+  ///        their transfer functions from the block entry if the block is not
+  ///        in @c InstValCache .
+  /// @param BB
+  /// @return A reference into @c InstValCache , which is only valid until
+  ///         @c InstValCacheSize other blocks have been materialized, since
+  ///         the storage of the evicted block is then recycled.
+  const std::vector<DomainVal_t> &materializeBB(const llvm::BasicBlock &BB) {
+    for (auto CacheIt = InstValCache.begin(); CacheIt != InstValCache.end();
+         ++CacheIt) {
+      if (CacheIt->first == &BB) {
+        InstValCache.splice(InstValCache.begin(), InstValCache, CacheIt);
+        return CacheIt->second;
       }
     }
+    std::vector<DomainVal_t> InstVals;
+    if (InstValCache.size() >= std::max(1U, InstValCacheSize.getValue())) {
+      // Recycle the storage of the least recently used block.
+      InstVals = std::move(InstValCache.back().second);
+      InstValCache.pop_back();
+    }
+    InstVals.resize(BB.size(), bc());
 
+    const DomainVal_t *Input = &BVs.at(&BB);
+    for (const auto &I : getInstConstRange(BB)) {
+      DomainVal_t &Output = InstVals[InstIdx.at(&I)];
+      transferFunc(I, *Input, Output);
+      Input = &Output;
+    }
+    InstValCache.emplace_front(&BB, std::move(InstVals));
+    return InstValCache.front().second;
+  }
+  /// @}
 
-    while(traverseCFG(F)){
+public:
+  /// @brief Compute the fixpoint of the analysis over the function. Only the
+  ///        values at the block boundaries are kept, the per-instruction ones
+  ///        are recomputed on demand.
+  /// @param F
+  /// @sa @c getIn @c getOut
+  void solve(const llvm::Function &F) {
+    DomainIdMap.clear();
+    DomainVector.clear();
+    ValueDomainIds.clear();
+    BVs.clear();
+    BBExitVals.clear();
+    InstIdx.clear();
+    InstValCache.clear();
+    initializeDomain(F);
+    initializeInstDomainIds(F);
+
+    BCVal = bc();
+    BoundaryBuf = bc();
+    TransferBuf = bc();
+    InstBufs[0] = bc();
+    InstBufs[1] = bc();
+    for (const llvm::BasicBlock &BB : F) {
+      BBExitVals.emplace(&BB, MeetOp.top(DomainVector.size()));
+      size_t Idx = 0;
+      for (const auto &I : getInstConstRange(BB)) {
+        InstIdx.emplace(&I, Idx++);
+      }
+    }
+    summarizeBBs(F);
 
+    initializeBBOrder(F);
+    BBOrderIdx.clear();
+    for (size_t Idx = 0; Idx < BBOrder.size(); ++Idx) {
+      BBOrderIdx.emplace(BBOrder[Idx], Idx);
+    }
+
+    initializeWideningPoints(F);
+
+    NumBBVisits = 0;
+    BBVisitCounts.assign(BBOrder.size(), 0);
+    IsNarrowing = false;
+    if (Solver == SolverKind::Worklist) {
+      solveWorklist(F);
+    } else {
+      while (traverseCFG(F)) {
+      }
+    }
+    // The widened fixpoint over-approximates the values that reach every
+    // program point, hence sweeping the CFG again from it stays sound and
+    // recovers some of the precision lost to widening.
+    IsNarrowing = true;
+    for (unsigned Pass = 0; !WideningPoints.empty() && Pass < NarrowingPasses;
+         ++Pass) {
+      if (!traverseCFG(F)) {
+        break;
+      }
     }
 
     for(auto &BB : F)
       BVs.emplace(&BB, getBoundaryVal(BB));
+    // The exit values of the widening points have been computed from their
+    // widened entry values.
+    for (auto &BBPoint : WideningPoints) {
+      BVs.at(BBPoint.first) = std::move(BBPoint.second.Prev);
+    }
+    WideningPoints.clear();
+  }
+  /// @brief Dump the result of the last solved function, with as much detail
+  ///        as @c DumpVerbosity requests.
+  /// @param F
+  void print(const llvm::Function &F) {
+    if (DumpVerbosity == Verbosity::None) {
+      return;
+    }
+    // errs() is unbuffered, hence write through a buffered stream on the same
+    // file descriptor instead.
+    llvm::errs().flush();
+    llvm::raw_fd_ostream Errs(STDERR_FILENO, /*shouldClose=*/false);
+    llvm::ModuleSlotTracker MST(F.getParent());
+    MST.incorporateFunction(F);
+    DumpStream DS = {.Outs = llvm::outs(),
+                     .Errs = Errs,
+                     .MST = MST,
+                     .Prefix = "CHECK: [" + getName() + "] "};
+
+    if (DumpVerbosity >= Verbosity::Block) {
+      for (const llvm::BasicBlock &BB : F) {
+        printBBDomainVals(BB, DS, DumpVerbosity == Verbosity::Full);
+      }
+    }
+    Errs << DS.Prefix << "Converged after " << NumBBVisits
+         << " basic block visits";
+    const auto MaxVisitsIt =
+        std::max_element(BBVisitCounts.begin(), BBVisitCounts.end());
+    if (MaxVisitsIt != BBVisitCounts.end()) {
+      Errs << ", at most " << *MaxVisitsIt << " of one basic block";
+    }
+    Errs << "\n";
+  }
+
+  /// @name Result queries
+  /// @{
+
+  const DomainIdMap_t &getDomainIdMap() const { return DomainIdMap; }
+  const DomainVector_t &getDomainVector() const { return DomainVector; }
+  /// @brief Get the domain id associated with @p Val , or @c NoDomainId if
+  ///        there is none.
+  size_t getDomainId(const llvm::Value *const Val) const {
+    const auto Iter = ValueDomainIds.find(Val);
+    return Iter == ValueDomainIds.end() ? NoDomainId : Iter->second;
+  }
+  /// @brief Get the domain value at the entry of the basic block, in
+  ///        traversal order.
+  const DomainVal_t &getEntryVal(const llvm::BasicBlock &BB) const {
+    return BVs.at(&BB);
+  }
+  /// @brief Get the domain value at the exit of the basic block, in
+  ///        traversal order.
+  const DomainVal_t &getExitVal(const llvm::BasicBlock &BB) const {
+    return BBExitVals.at(&BB);
+  }
+  /// @brief Get the domain value right before the instruction, i.e., the
+  ///        input of its transfer function.
+  /// @param Inst
+  /// @return A copy of the value, since the one in @c InstValCache does not
+  ///         outlive the eviction of its block.
+  DomainVal_t getIn(const llvm::Instruction &Inst) {
+    const size_t Idx = InstIdx.at(&Inst);
+    if (Idx == 0) {
+      return BVs.at(Inst.getParent());
+    }
+    return materializeBB(*Inst.getParent())[Idx - 1];
+  }
+  /// @brief Get the domain value right after the instruction, i.e., the
+  ///        output of its transfer function.
+  /// @param Inst
+  /// @return A copy of the value, as for @c getIn .
+  DomainVal_t getOut(const llvm::Instruction &Inst) {
+    return materializeBB(*Inst.getParent())[InstIdx.at(&Inst)];
+  }
 
-    printInstDomainValMap(F);
-    return std::make_tuple(DomainIdMap, DomainVector, BVs, InstDomainValMap);
+  size_t getNumBBVisits() const { return NumBBVisits; }
+  /// @brief Get the number of times that the solver visited @p BB in the
+  ///        last run, so as to bound the latency of the analysis.
+  size_t getNumBBVisits(const llvm::BasicBlock &BB) const {
+    return BBVisitCounts[BBOrderIdx.at(&BB)];
   }
 
+  /// @}
+
 }; // class Framework
 
+/// @brief Owning handle to an analysis that has been solved on one function.
+///
+///        This is what the analysis manager caches, so the consumers of
+///        @c FAM.getResult access the domain and the boundary values through
+///        const references instead of receiving copies. Queries of
+///        per-instruction values go through the LRU cache of the analysis,
+///        hence they are non-const, return copies and are not thread-safe.
+template <typename TAnalysis> class AnalysisResult {
+private:
+  std::unique_ptr<TAnalysis> Analysis;
+
+public:
+  explicit AnalysisResult(std::unique_ptr<TAnalysis> Analysis)
+      : Analysis(std::move(Analysis)) {}
+
+  /// @brief Solve a fresh instance of the analysis on @p F and, unless
+  ///        @p Print is false, dump its domain values.
+  static AnalysisResult compute(const llvm::Function &F,
+                                const bool Print = true) {
+    std::unique_ptr<TAnalysis> Analysis = std::make_unique<TAnalysis>();
+    Analysis->solve(F);
+    if (Print) {
+      Analysis->print(F);
+    }
+    return AnalysisResult(std::move(Analysis));
+  }
+  void print(const llvm::Function &F) const { Analysis->print(F); }
+  /// @brief Get the solved analysis, for the queries that are specific to it.
+  const TAnalysis &get() const { return *Analysis; }
+
+  const auto &getDomainIdMap() const { return Analysis->getDomainIdMap(); }
+  const auto &getDomainVector() const { return Analysis->getDomainVector(); }
+  size_t getDomainId(const llvm::Value *const Val) const {
+    return Analysis->getDomainId(Val);
+  }
+  const auto &getEntryVal(const llvm::BasicBlock &BB) const {
+    return Analysis->getEntryVal(BB);
+  }
+  const auto &getExitVal(const llvm::BasicBlock &BB) const {
+    return Analysis->getExitVal(BB);
+  }
+  auto getIn(const llvm::Instruction &Inst) { return Analysis->getIn(Inst); }
+  auto getOut(const llvm::Instruction &Inst) {
+    return Analysis->getOut(Inst);
+  }
+  size_t getNumBBVisits() const { return Analysis->getNumBBVisits(); }
+  size_t getNumBBVisits(const llvm::BasicBlock &BB) const {
+    return Analysis->getNumBBVisits(BB);
+  }
+};
+
 /// @brief For each domain element type, we have to define:
 ///        - The default constructor
 ///        - The meet operators (for intersect/union)
@@ -219,6 +761,11 @@ struct Bool {
   explicit operator bool() const { return Value; }
 };
 
+/// @brief Lattice value of constant propagation: undefined (top), an integer
+///        constant of any bit width, or not a constant (bottom).
+///
+///        The constant is an @c llvm::APInt , which keeps values of up to 64
+///        bits inline, hence the common i1/i32/i64 cases do not allocate.
 class ConstValue{
 public:
   enum class Type {
@@ -228,19 +775,13 @@ public:
   };
 private:
   Type IsConst;
-  std::int64_t Value;
+  llvm::APInt Value;
 
 public:
 
-  ConstValue(): IsConst(Type::Undef), Value(0){}
-  ConstValue(Type IsConst, int64_t Value) {
-    this->IsConst = IsConst; 
-    this->Value = Value;
-  }
-  ConstValue(const ConstValue &Other){
-    IsConst = Other.IsConst;
-    Value = Other.Value;
-  }
+  ConstValue(): IsConst(Type::Undef) {}
+  ConstValue(Type IsConst, llvm::APInt Value)
+      : IsConst(IsConst), Value(std::move(Value)) {}
 
   bool isConst() const {
     return this->IsConst == Type::ConstantInt;
@@ -254,24 +795,33 @@ public:
     return this->IsConst == Type::NAC;
   }
 
-  int64_t getConst() const {
+  const llvm::APInt &getConst() const {
     return this->Value;
   }
 
-  static ConstValue getConst(int64_t value){
-    return ConstValue(Type::ConstantInt, value);
+  static ConstValue getConst(llvm::APInt value){
+    return ConstValue(Type::ConstantInt, std::move(value));
   }
 
   static ConstValue getUndef(){
-    return ConstValue(Type::Undef, 0);
+    return ConstValue();
   }
 
   static ConstValue getNac(){
-    return ConstValue(Type::NAC, 0);
+    return ConstValue(Type::NAC, llvm::APInt());
   }
 
+  bool operator==(const ConstValue &Other) const {
+    if (IsConst != Other.IsConst) {
+      return false;
+    }
+    // Constants of different widths are never equal, and comparing them
+    // directly would assert.
+    return !isConst() || (Value.getBitWidth() == Other.Value.getBitWidth() &&
+                          Value == Other.Value);
+  }
   bool operator!=(const ConstValue& Other) const{
-    return (this->Value != Other.Value || this->IsConst != Other.IsConst);
+    return !(*this == Other);
   }
 
   explicit operator bool() const{
@@ -284,11 +834,61 @@ public:
 
 template<>
 struct ValuePrinter<ConstValue> {
-  static std::string print(const dfa::ConstValue &V) {
-    std::string res = "=";
-    if(V.isConst())
-      return res + std::to_string(V.getConst());
-    return res + "NAC";
+  static void print(llvm::raw_ostream &Outs, const dfa::ConstValue &V) {
+    Outs << "=";
+    if (V.isConst()) {
+      // Booleans are printed as 0/1 rather than as 0/-1.
+      V.getConst().print(Outs, /*isSigned=*/V.getConst().getBitWidth() != 1);
+    } else {
+      Outs << "NAC";
+    }
+  }
+};
+
+/// @brief Lattice value of range propagation: undefined (top), i.e., no value
+///        has reached the program point yet, or the range of integers that
+///        the variable may hold, down to the full set (bottom).
+class RangeValue {
+private:
+  bool IsUndef;
+  /// @brief Only meaningful if not undefined, since the bit width of an
+  ///        undefined value is unknown.
+  llvm::ConstantRange Range;
+
+public:
+  RangeValue() : IsUndef(true), Range(1, /*isFullSet=*/false) {}
+  explicit RangeValue(llvm::ConstantRange Range)
+      : IsUndef(false), Range(std::move(Range)) {}
+
+  bool isUndef() const { return IsUndef; }
+  const llvm::ConstantRange &getRange() const { return Range; }
+
+  static RangeValue getUndef() { return RangeValue(); }
+  static RangeValue getFull(const unsigned BitWidth) {
+    return RangeValue(llvm::ConstantRange::getFull(BitWidth));
+  }
+
+  bool operator==(const RangeValue &Other) const {
+    if (IsUndef || Other.IsUndef) {
+      return IsUndef == Other.IsUndef;
+    }
+    return Range.getBitWidth() == Other.Range.getBitWidth() &&
+           Range == Other.Range;
+  }
+  bool operator!=(const RangeValue &Other) const { return !(*this == Other); }
+
+  explicit operator bool() const { return !IsUndef; }
+};
+
+template <> struct ValuePrinter<RangeValue> {
+  static void print(llvm::raw_ostream &Outs, const dfa::RangeValue &V) {
+    Outs << "=";
+    const llvm::ConstantRange &Range = V.getRange();
+    if (const llvm::APInt *const Single = Range.getSingleElement()) {
+      Single->print(Outs, /*isSigned=*/Range.getBitWidth() != 1);
+    } else {
+      Range.print(Outs);
+    }
   }
 };
 } // namespace 
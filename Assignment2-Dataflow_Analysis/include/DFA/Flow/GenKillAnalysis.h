@@ -0,0 +1,123 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include "../MeetOp.h"
+#include "Framework.h"
+
+#include <type_traits>
+
+namespace dfa {
+
+extern llvm::cl::opt<bool> UseBBSummaries;
+
+/// @brief Layer on top of a forward/backward boolean analysis whose transfer
+///        functions all have the form `OUT = (IN - KILL) U GEN` .
+///
+///        Such transfer functions compose, so every basic block is summarized
+///        by one pair of bit-vectors before the fixpoint iteration and the
+///        solver only iterates over the block boundaries. The summaries are
+///        obtained by applying the transfer functions of the block to the
+///        empty set (which yields GEN) and to the full set (which yields the
+///        mask of the elements that are not killed), so that the derived
+///        analyses only have to implement @c transferFunc .
+template <typename TFlowAnalysis>
+class GenKillAnalysis : public TFlowAnalysis {
+protected:
+  using typename TFlowAnalysis::DomainVal_t;
+  using typename TFlowAnalysis::InstDomainIds;
+  using TFlowAnalysis::initializeInstDomainIds;
+
+  static_assert(
+      std::is_same<typename TFlowAnalysis::DomainVal_t,
+                   DomainValTraits<Bool>::DomainVal_t>::value,
+      "Gen/Kill summaries are only available for boolean domain values");
+
+  struct BBSummary {
+    DomainVal_t Gen;
+    /// @brief Output of the block for the full set as input, i.e., the
+    ///        complement of its KILL set united with its GEN set (which
+    ///        includes the elements that the block kills and then generates
+    ///        again), rather than the plain complement of KILL.
+    DomainVal_t Preserved;
+  };
+  std::unordered_map<const llvm::BasicBlock *, BBSummary> BBSummaries;
+
+  /// @brief Kill sets of the instructions, as bit-vectors over the domain.
+  ///        They are only built for the kill sets that are dense enough for
+  ///        a word-wise AND-NOT to be cheaper than clearing the bits one by
+  ///        one, which also bounds their total size by a constant number of
+  ///        domain values per domain element.
+  llvm::DenseMap<const llvm::Instruction *, DomainVal_t> KillMasks;
+
+  bool hasKillMask(const InstDomainIds &Ids) const {
+    return !Ids.Kills.empty() &&
+           Ids.Kills.size() * DomainVal_t::BitsPerWord >=
+               this->DomainVector.size();
+  }
+  void initializeInstDomainIds(const llvm::Function &F) override {
+    TFlowAnalysis::initializeInstDomainIds(F);
+    KillMasks.clear();
+    for (const llvm::Instruction &Inst : llvm::instructions(&F)) {
+      const InstDomainIds &Ids = this->getInstDomainIds(Inst);
+      if (!hasKillMask(Ids)) {
+        continue;
+      }
+      DomainVal_t Mask(this->DomainVector.size());
+      for (const size_t DomainId : Ids.Kills) {
+        Mask.set(DomainId);
+      }
+      KillMasks.try_emplace(&Inst, std::move(Mask));
+    }
+  }
+  /// @brief Clear the kill set of @p Inst from @p Val .
+  void applyKills(const llvm::Instruction &Inst, const InstDomainIds &Ids,
+                  DomainVal_t &Val) const {
+    if (hasKillMask(Ids)) {
+      Val.reset(KillMasks.find(&Inst)->second);
+      return;
+    }
+    for (const size_t DomainId : Ids.Kills) {
+      Val.reset(DomainId);
+    }
+  }
+
+  /// @brief Apply the transfer functions of the block to @p Val in place.
+  void applyTransferFuncs(const llvm::BasicBlock &BB, DomainVal_t &Val) {
+    DomainVal_t Output = this->bc();
+    for (const auto &I : this->getInstConstRange(BB)) {
+      this->transferFunc(I, Val, Output);
+      std::swap(Val, Output);
+    }
+  }
+
+  bool summarizeBBs(const llvm::Function &F) override {
+    BBSummaries.clear();
+    if (!UseBBSummaries) {
+      return false;
+    }
+    for (const llvm::BasicBlock &BB : F) {
+      BBSummary Summary = {.Gen = DomainVal_t(this->DomainVector.size()),
+                           .Preserved =
+                               DomainVal_t(this->DomainVector.size(), true)};
+      applyTransferFuncs(BB, Summary.Gen);
+      applyTransferFuncs(BB, Summary.Preserved);
+      BBSummaries.emplace(&BB, std::move(Summary));
+    }
+    return true;
+  }
+
+  bool transferBB(const llvm::BasicBlock &BB, const DomainVal_t &IBV,
+                  DomainVal_t &OBV) override {
+    if (BBSummaries.empty()) {
+      return TFlowAnalysis::transferBB(BB, IBV, OBV);
+    }
+    const BBSummary &Summary = BBSummaries.at(&BB);
+    DomainVal_t &TransferBuf = this->TransferBuf;
+
+    TransferBuf = IBV;
+    TransferBuf.intersectWith(Summary.Preserved);
+    TransferBuf.unionWith(Summary.Gen);
+    return this->updateODV(OBV);
+  }
+};
+
+} // namespace dfa
@@ -0,0 +1,39 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dfa {
+namespace kernel {
+
+using Word_t = std::uint64_t;
+
+/// @brief Instruction sets for which a meet kernel is available.
+enum class ISA { Scalar, SSE2, AVX2 };
+
+const char *getISAName(const ISA Kind);
+
+/// @brief Word-wise kernels of the boolean meet operators. Every kernel
+///        updates @p Dst in place and returns whether any of its words has
+///        been modified.
+struct MeetKernels {
+  bool (*And)(Word_t *const Dst, const Word_t *const Src,
+              const std::size_t NumWords);
+  bool (*Or)(Word_t *const Dst, const Word_t *const Src,
+             const std::size_t NumWords);
+  /// @brief `Dst &= ~Src`, used to apply kill masks.
+  bool (*AndNot)(Word_t *const Dst, const Word_t *const Src,
+                 const std::size_t NumWords);
+};
+
+/// @brief Check whether the host CPU is able to run the kernels of @p Kind .
+bool isISASupported(const ISA Kind);
+/// @brief Get the kernels of a specific instruction set.
+/// @sa @c isISASupported
+const MeetKernels &getMeetKernels(const ISA Kind);
+/// @brief Get the best kernels for the host CPU. The dispatch is resolved
+///        once, the first time this function is called.
+const MeetKernels &getMeetKernels();
+
+} // namespace kernel
+} // namespace dfa
@@ -2,22 +2,60 @@
 
 #include <vector>
 #include "./Flow/Framework.h"
+#include "PackedBitVector.h"
+
 namespace dfa {
 
+/// @brief Container that holds one domain value, i.e., one lattice value per
+///        domain element. By default every element takes a full @c TValue .
+template <typename TValue> struct DomainValTraits {
+  using DomainVal_t = std::vector<TValue>;
+};
+/// @brief Boolean lattices are packed into 64-bit words, so that the meet
+///        and transfer functions can operate on one word at a time.
+template <> struct DomainValTraits<Bool> {
+  using DomainVal_t = PackedBitVector;
+};
+
 template <typename TValue> 
 struct MeetOpBase {
-  using DomainVal_t = std::vector<TValue>;
+  using DomainVal_t = typename DomainValTraits<TValue>::DomainVal_t;
   /// @brief Apply the meet operator using two operands.
   /// @param LHS
   /// @param RHS
   /// @return
-  virtual DomainVal_t operator()(const DomainVal_t &LHS,
-                                 const DomainVal_t &RHS) const = 0;
+  DomainVal_t operator()(const DomainVal_t &LHS,
+                         const DomainVal_t &RHS) const {
+    DomainVal_t Result = LHS;
+    meetInto(Result, RHS);
+    return Result;
+  }
+  /// @brief Apply the meet operator in place, i.e., `Dst = Dst meet Src`.
+  /// @param Dst
+  /// @param Src
+  /// @return Whether @p Dst has been changed.
+  virtual bool meetInto(DomainVal_t &Dst, const DomainVal_t &Src) const = 0;
   /// @brief Return a domain value that represents the top element, used when
   ///        doing the initialization.
   /// @param DomainSize
   /// @return
   virtual DomainVal_t top(const std::size_t DomainSize) const = 0;
+  /// @brief Whether the lattice may have infinite ascending chains, in which
+  ///        case the solver applies @c widenInto at the loop headers.
+  virtual bool hasWidening() const { return false; }
+  /// @brief Widen @p Dst , the new value at the entry of a loop header, with
+  ///        @p Prev , the value of the previous visit, so that the sequence of
+  ///        values at the header stabilizes after a bounded number of steps.
+  /// @param Dst
+  /// @param Prev
+  virtual void widenInto(DomainVal_t &Dst, const DomainVal_t &Prev) const {}
+  /// @brief Narrow @p Prev , the value at the entry of a loop header after
+  ///        widening, with @p Dst , the value that is recomputed from it. The
+  ///        result, stored in @p Dst , has to stay above @p Dst . By default
+  ///        @p Dst is kept as is.
+  /// @param Dst
+  /// @param Prev
+  virtual void narrowInto(DomainVal_t &Dst, const DomainVal_t &Prev) const {}
 };
 
 
@@ -25,26 +63,18 @@ template <typename TValue = dfa::Bool>
 struct Intersect final : MeetOpBase<TValue> {
   using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
 
-  DomainVal_t operator()(const DomainVal_t &LHS,
-                         const DomainVal_t &RHS) const final {
+  bool meetInto(DomainVal_t &Dst, const DomainVal_t &Src) const final {
 
     /// @todo(CSCD70) Please complete this method.
-    DomainVal_t tmp = DomainVal_t(LHS.size());
-    for(std::size_t idx = 0; idx < LHS.size(); ++idx){
-      if(LHS[idx] && RHS[idx])
-        tmp[idx] = TValue{true};
-    }
 
-    return tmp;
+    return Dst.intersectWith(Src);
   }
 
   DomainVal_t top(const std::size_t DomainSize) const final {
 
     /// @todo(CSCD70) Please complete this method.
-    DomainVal_t result = DomainVal_t(DomainSize);
-    for(std::size_t idx = 0; idx < DomainSize; ++idx)
-      result[idx] = TValue{true};
-    return result;
+
+    return DomainVal_t(DomainSize, true);
   }
 };
 
@@ -53,23 +83,17 @@ template <typename TValue = dfa::Bool>
 struct Union final : MeetOpBase<TValue> {
   using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
 
-  DomainVal_t operator()(const DomainVal_t &LHS,
-                         const DomainVal_t &RHS) const final {
+  bool meetInto(DomainVal_t &Dst, const DomainVal_t &Src) const final {
 
     /// @todo(CSCD70) Please complete this method.
-    DomainVal_t tmp = DomainVal_t(LHS.size());
-    for(std::size_t idx = 0; idx < LHS.size(); ++idx){
-      if(LHS[idx] || RHS[idx])
-        tmp[idx] = TValue{true};
-    }
 
-    return tmp;
+    return Dst.unionWith(Src);
   }
   DomainVal_t top(const std::size_t DomainSize) const final {
 
     /// @todo(CSCD70) Please complete this method.
 
-    return DomainVal_t(DomainSize, TValue{false});
+    return DomainVal_t(DomainSize, false);
   }
 };
 
@@ -84,21 +108,23 @@ struct ConstIntersect final : MeetOpBase<TValue> {
       return R;
     if(R.isUndef())
       return L;
-    if(L.getConst() == R.getConst())
+    if(L == R)
       return L;
     return ConstValue::getNac();  
   }
 
-  DomainVal_t operator()(const DomainVal_t &LHS,
-                         const DomainVal_t &RHS) const final {
+  bool meetInto(DomainVal_t &Dst, const DomainVal_t &Src) const final {
 
     /// @todo(CSCD70) Please complete this method.
-    DomainVal_t tmp = DomainVal_t(LHS.size());
-    for(std::size_t idx = 0; idx < LHS.size(); ++idx){
-      tmp[idx] = ValueMeet(LHS[idx], RHS[idx]);
+    bool Changed = false;
+    for(std::size_t idx = 0; idx < Dst.size(); ++idx){
+      TValue Met = ValueMeet(Dst[idx], Src[idx]);
+      if (Met != Dst[idx]) {
+        Dst[idx] = Met;
+        Changed = true;
+      }
     }
-    return tmp;
-    
+    return Changed;
   }
 
   DomainVal_t top(const std::size_t DomainSize) const final {
@@ -111,5 +137,90 @@ struct ConstIntersect final : MeetOpBase<TValue> {
   }
 };
 
+/// @brief Meet operator of range propagation, i.e., the union of the ranges
+///        that reach a program point. Ranges have infinite ascending chains in
+///        practice (e.g., the range of a loop counter grows by one on every
+///        iteration), hence they are widened at the loop headers.
+template <typename TValue = dfa::RangeValue>
+struct RangeUnion final : MeetOpBase<TValue> {
+  using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
+
+  TValue ValueMeet(const TValue &L, const TValue &R) const {
+    if (L.isUndef())
+      return R;
+    if (R.isUndef())
+      return L;
+    return TValue(L.getRange().unionWith(R.getRange()));
+  }
+  /// @brief Widen @p Prev with @p New : every signed bound of @p Prev that
+  ///        @p New exceeds jumps to the extreme value of the type, hence each
+  ///        value is widened at most twice before becoming the full set.
+  TValue ValueWiden(const TValue &Prev, const TValue &New) const {
+    if (Prev.isUndef() || New.isUndef())
+      return ValueMeet(Prev, New);
+    const llvm::ConstantRange &P = Prev.getRange(), &N = New.getRange();
+    if (P.contains(N))
+      return Prev;
+    if (P.isEmptySet())
+      return New;
+    const unsigned BitWidth = P.getBitWidth();
+    const llvm::ConstantRange Hull =
+        P.unionWith(N, llvm::ConstantRange::Signed);
+    llvm::APInt Lower = Hull.getSignedMin(), Upper = Hull.getSignedMax();
+    if (N.getSignedMin().slt(P.getSignedMin()))
+      Lower = llvm::APInt::getSignedMinValue(BitWidth);
+    if (N.getSignedMax().sgt(P.getSignedMax()))
+      Upper = llvm::APInt::getSignedMaxValue(BitWidth);
+    return TValue(llvm::ConstantRange::getNonEmpty(std::move(Lower),
+                                                   std::move(Upper) + 1));
+  }
+
+  /// @brief Narrow @p Prev with @p New : only the signed bounds of @p Prev
+  ///        that widening has pushed to the extreme values of the type are
+  ///        replaced by the ones of @p New , hence each bound is narrowed at
+  ///        most once.
+  TValue ValueNarrow(const TValue &Prev, const TValue &New) const {
+    if (Prev.isUndef() || New.isUndef() || New.getRange().isEmptySet())
+      return Prev.isUndef() ? New : Prev;
+    const llvm::ConstantRange &P = Prev.getRange(), &N = New.getRange();
+    if (P.isEmptySet())
+      return Prev;
+    llvm::APInt Lower = P.getSignedMin(), Upper = P.getSignedMax();
+    if (Lower.isMinSignedValue())
+      Lower = N.getSignedMin();
+    if (Upper.isMaxSignedValue())
+      Upper = N.getSignedMax();
+    if (Lower.sgt(Upper))
+      return Prev;
+    return TValue(llvm::ConstantRange::getNonEmpty(std::move(Lower),
+                                                   std::move(Upper) + 1));
+  }
+
+  bool meetInto(DomainVal_t &Dst, const DomainVal_t &Src) const final {
+    bool Changed = false;
+    for (std::size_t Idx = 0; Idx < Dst.size(); ++Idx) {
+      TValue Met = ValueMeet(Dst[Idx], Src[Idx]);
+      if (Met != Dst[Idx]) {
+        Dst[Idx] = std::move(Met);
+        Changed = true;
+      }
+    }
+    return Changed;
+  }
+  DomainVal_t top(const std::size_t DomainSize) const final {
+    return DomainVal_t(DomainSize);
+  }
+  bool hasWidening() const final { return true; }
+  void widenInto(DomainVal_t &Dst, const DomainVal_t &Prev) const final {
+    for (std::size_t Idx = 0; Idx < Dst.size(); ++Idx) {
+      Dst[Idx] = ValueWiden(Prev[Idx], Dst[Idx]);
+    }
+  }
+  void narrowInto(DomainVal_t &Dst, const DomainVal_t &Prev) const final {
+    for (std::size_t Idx = 0; Idx < Dst.size(); ++Idx) {
+      Dst[Idx] = ValueNarrow(Prev[Idx], Dst[Idx]);
+    }
+  }
+};
 
 } // namespace dfa
@@ -0,0 +1,59 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include "Flow/Framework.h"
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+
+#include <memory>
+#include <vector>
+
+namespace dfa {
+
+extern llvm::cl::opt<unsigned> NumThreads;
+
+/// @brief Module pass that solves a function-local analysis on every defined
+///        function of the module in parallel.
+///
+///        Each task owns a fresh instance of the analysis, so the workers do
+///        not share any state apart from the (read-only) IR. The results are
+///        stored by function position and printed afterwards in module order,
+///        hence the output does not depend on the number of threads or on the
+///        scheduling.
+template <typename TAnalysis>
+class ModuleDriverPass
+    : public llvm::PassInfoMixin<ModuleDriverPass<TAnalysis>> {
+private:
+  using Result_t = AnalysisResult<TAnalysis>;
+
+public:
+  llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &) {
+    std::vector<const llvm::Function *> Funcs;
+    for (const llvm::Function &F : M) {
+      if (!F.isDeclaration()) {
+        Funcs.push_back(&F);
+      }
+    }
+    std::vector<std::unique_ptr<Result_t>> Results(Funcs.size());
+    {
+      // A thread count of 0 lets LLVM use all the available hardware threads.
+      llvm::ThreadPool Pool(llvm::hardware_concurrency(NumThreads));
+      for (size_t Idx = 0; Idx < Funcs.size(); ++Idx) {
+        Pool.async([&Funcs, &Results, Idx]() {
+          Results[Idx] = std::make_unique<Result_t>(
+              Result_t::compute(*Funcs[Idx], false));
+        });
+      }
+      Pool.wait();
+    }
+    for (size_t Idx = 0; Idx < Funcs.size(); ++Idx) {
+      Results[Idx]->print(*Funcs[Idx]);
+    }
+    return llvm::PreservedAnalyses::all();
+  }
+};
+
+} // namespace dfa
@@ -0,0 +1,138 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include "MeetKernels.h"
+#include "Utility.h"
+
+#include <vector>
+
+namespace dfa {
+
+/// @brief Dense bit-vector whose storage is exposed as an array of 64-bit
+///        words, so that the meet operators can be applied by the
+///        vectorized kernels in @c MeetKernels.h .
+class PackedBitVector {
+public:
+  using Word_t = kernel::Word_t;
+  static constexpr size_t BitsPerWord = sizeof(Word_t) * 8;
+
+private:
+  std::vector<Word_t> Words;
+  size_t NumBits = 0;
+
+  static size_t getNumWords(const size_t NumBits) {
+    return (NumBits + BitsPerWord - 1) / BitsPerWord;
+  }
+  /// @brief Keep the bits beyond @c NumBits cleared, so that words can be
+  ///        compared and counted without masking.
+  void clearUnusedBits() {
+    if (const size_t UsedBits = NumBits % BitsPerWord) {
+      Words.back() &= (Word_t(1) << UsedBits) - 1;
+    }
+  }
+
+public:
+  PackedBitVector() = default;
+  explicit PackedBitVector(const size_t NumBits, const bool Init = false)
+      : Words(getNumWords(NumBits), Init ? ~Word_t(0) : Word_t(0)),
+        NumBits(NumBits) {
+    clearUnusedBits();
+  }
+
+  size_t size() const { return NumBits; }
+  size_t getNumWords() const { return Words.size(); }
+  Word_t *data() { return Words.data(); }
+  const Word_t *data() const { return Words.data(); }
+
+  bool test(const size_t Idx) const {
+    return (Words[Idx / BitsPerWord] >> (Idx % BitsPerWord)) & 1;
+  }
+  bool operator[](const size_t Idx) const { return test(Idx); }
+  PackedBitVector &set(const size_t Idx) {
+    Words[Idx / BitsPerWord] |= Word_t(1) << (Idx % BitsPerWord);
+    return *this;
+  }
+  PackedBitVector &reset(const size_t Idx) {
+    Words[Idx / BitsPerWord] &= ~(Word_t(1) << (Idx % BitsPerWord));
+    return *this;
+  }
+
+  bool any() const {
+    for (const Word_t Word : Words) {
+      if (Word != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+  size_t count() const {
+    size_t NumSetBits = 0;
+    for (const Word_t Word : Words) {
+      NumSetBits += __builtin_popcountll(Word);
+    }
+    return NumSetBits;
+  }
+  /// @brief Get the index of the first set bit at or after @p Idx , or
+  ///        @c size() if there is none.
+  size_t findNext(const size_t Idx) const {
+    if (Idx >= NumBits) {
+      return NumBits;
+    }
+    size_t WordIdx = Idx / BitsPerWord;
+    Word_t Word = Words[WordIdx] & (~Word_t(0) << (Idx % BitsPerWord));
+    while (Word == 0) {
+      if (++WordIdx == Words.size()) {
+        return NumBits;
+      }
+      Word = Words[WordIdx];
+    }
+    return WordIdx * BitsPerWord + __builtin_ctzll(Word);
+  }
+
+  /// @name Word-wise operations
+  /// @{
+
+  /// @brief Intersect with @p RHS in place.
+  /// @return Whether any bit has been cleared.
+  bool intersectWith(const PackedBitVector &RHS) {
+    CHECK(NumBits == RHS.NumBits)
+        << "Size of bit-vectors has to be the same, but got " << NumBits
+        << " vs. " << RHS.NumBits << " instead";
+    return kernel::getMeetKernels().And(Words.data(), RHS.Words.data(),
+                                        Words.size());
+  }
+  /// @brief Union with @p RHS in place.
+  /// @return Whether any bit has been set.
+  bool unionWith(const PackedBitVector &RHS) {
+    CHECK(NumBits == RHS.NumBits)
+        << "Size of bit-vectors has to be the same, but got " << NumBits
+        << " vs. " << RHS.NumBits << " instead";
+    return kernel::getMeetKernels().Or(Words.data(), RHS.Words.data(),
+                                       Words.size());
+  }
+  /// @brief Clear the bits that are set in @p RHS , in place.
+  /// @return Whether any bit has been cleared.
+  bool reset(const PackedBitVector &RHS) {
+    CHECK(NumBits == RHS.NumBits)
+        << "Size of bit-vectors has to be the same, but got " << NumBits
+        << " vs. " << RHS.NumBits << " instead";
+    return kernel::getMeetKernels().AndNot(Words.data(), RHS.Words.data(),
+                                           Words.size());
+  }
+  PackedBitVector &operator&=(const PackedBitVector &RHS) {
+    intersectWith(RHS);
+    return *this;
+  }
+  PackedBitVector &operator|=(const PackedBitVector &RHS) {
+    unionWith(RHS);
+    return *this;
+  }
+
+  /// @}
+
+  bool operator==(const PackedBitVector &RHS) const {
+    return NumBits == RHS.NumBits && Words == RHS.Words;
+  }
+  bool operator!=(const PackedBitVector &RHS) const { return !(*this == RHS); }
+};
+
+} // namespace dfa
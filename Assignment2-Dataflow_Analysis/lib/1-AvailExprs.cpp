@@ -6,37 +6,52 @@ using namespace llvm;
 
 AnalysisKey AvailExprs::Key;
 
+static cl::opt<bool> UseValueNumbering(
+    "dfa-avail-vn",
+    cl::desc("Merge the available expressions that have the same value "
+             "number into one domain element"),
+    cl::init(true));
+
+void AvailExprs::initializeDomain(const llvm::Function &F) {
+  VN.clear();
+  VNDomainIds.clear();
+  if (UseValueNumbering) {
+    VN.numberFunction(F);
+  }
+  ForwardAnalysis_t::initializeDomain(F);
+}
+
 void AvailExprs::initializeDomainFromInst(const llvm::Instruction &Inst) {
-  if (isa<BinaryOperator>(Inst)) {
-    dfa::Expression expr(*dyn_cast<BinaryOperator>(&Inst));
-    if (DomainIdMap.count(expr) == 0) {
-      DomainVector.push_back(expr);
-      DomainIdMap.insert(std::make_pair(expr, DomainVector.size() - 1));
-    }
+  const auto *const BO = dyn_cast<BinaryOperator>(&Inst);
+  if (BO == nullptr) {
+    return;
+  }
+  if (!UseValueNumbering) {
+    internDomainElem(dfa::Expression(*BO), BO);
+    return;
   }
+  // The first expression of each value number represents all the others.
+  const dfa::ValueNumbering::VN_t ExprVN = VN.getValueNumber(BO);
+  const auto Iter = VNDomainIds.find(ExprVN);
+  if (Iter != VNDomainIds.end()) {
+    ValueDomainIds.try_emplace(BO, Iter->second);
+    return;
+  }
+  VNDomainIds.try_emplace(ExprVN, internDomainElem(dfa::Expression(*BO), BO));
 }
 
 bool AvailExprs::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
                              DomainVal_t &ODV) {
 
   /// @todo(CSCD70) Please complete this method.
-  DomainVal_t tmp = IDV;
-
-  if (isa<BinaryOperator>(Inst)) {
-    dfa::Expression expr(*dyn_cast<BinaryOperator>(&Inst));
-
-    auto iter = DomainIdMap.find(expr);
-    if (iter != DomainIdMap.end()) {
-      tmp[iter->second].Value = true;
-    }
-  }
+  DomainVal_t &tmp = TransferBuf;
+  tmp = IDV;
 
-  for(std::size_t i = 0; i < tmp.size(); ++i){
-    if(tmp[i].Value != ODV[i].Value){
-      ODV = tmp;
-      return true;
-    }
+  const InstDomainIds &Ids = getInstDomainIds(Inst);
+  applyKills(Inst, Ids, tmp);
+  if (Ids.Def != NoDomainId) {
+    tmp.set(Ids.Def);
   }
 
-  return false;
+  return updateODV(ODV);
 }
@@ -0,0 +1,94 @@
+#include "DFA.h"
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/CFG.h>
+
+#include <vector>
+
+using namespace llvm;
+using dfa::PackedBitVector;
+
+AnalysisKey BlockLiveness::Key;
+
+void BlockLiveness::summarizeBB(const BasicBlock &BB, BBInfo &Info) const {
+  const size_t NumVars = Vars.size();
+  Info.UEUses = PackedBitVector(NumVars);
+  Info.Defs = PackedBitVector(NumVars);
+  Info.PHIUses.clear();
+
+  for (const Instruction &Inst : BB) {
+    // The incoming values of PHI nodes are used on the incoming edges, hence
+    // they are accounted for in the predecessors.
+    if (!isa<PHINode>(Inst)) {
+      for (const Value *const Op : Inst.operands()) {
+        const size_t VarId = getVarId(Op);
+        if (VarId != NoVarId && !Info.Defs.test(VarId)) {
+          Info.UEUses.set(VarId);
+        }
+      }
+    }
+    const size_t VarId = getVarId(&Inst);
+    if (VarId != NoVarId) {
+      Info.Defs.set(VarId);
+    }
+  }
+  SmallPtrSet<const BasicBlock *, 4> VisitedSuccs;
+  for (const BasicBlock *const Succ : successors(&BB)) {
+    if (!VisitedSuccs.insert(Succ).second) {
+      continue;
+    }
+    for (const PHINode &PHI : Succ->phis()) {
+      const size_t VarId = getVarId(PHI.getIncomingValueForBlock(&BB));
+      if (VarId != NoVarId) {
+        Info.PHIUses.push_back(VarId);
+      }
+    }
+  }
+}
+
+void BlockLiveness::solve(const Function &F) {
+  initialize(F);
+  BBInfos.assign(BBs.size(), BBInfo());
+  for (size_t BBId = 0; BBId < BBs.size(); ++BBId) {
+    BBInfo &Info = BBInfos[BBId];
+    summarizeBB(*BBs[BBId], Info);
+    LiveIns[BBId] = Info.UEUses;
+    for (const size_t VarId : Info.PHIUses) {
+      LiveOuts[BBId].set(VarId);
+    }
+  }
+
+  // Sweep over the blocks that are pending, in post-order, until none is
+  // left. Liveness only grows during the iteration, hence the live-out sets
+  // are accumulated in place rather than recomputed.
+  std::vector<bool> Pending(BBs.size(), true);
+  size_t NumPending = BBs.size();
+  PackedBitVector Tmp;
+  while (NumPending != 0) {
+    for (size_t BBId = 0; BBId < BBs.size(); ++BBId) {
+      if (!Pending[BBId]) {
+        continue;
+      }
+      Pending[BBId] = false;
+      --NumPending;
+      ++NumBBVisits;
+
+      const BasicBlock &BB = *BBs[BBId];
+      for (const BasicBlock *const Succ : successors(&BB)) {
+        LiveOuts[BBId].unionWith(LiveIns[BBIds.lookup(Succ)]);
+      }
+      Tmp = LiveOuts[BBId];
+      Tmp.reset(BBInfos[BBId].Defs);
+      if (!LiveIns[BBId].unionWith(Tmp)) {
+        continue;
+      }
+      for (const BasicBlock *const Pred : predecessors(&BB)) {
+        const unsigned PredId = BBIds.lookup(Pred);
+        if (!Pending[PredId]) {
+          Pending[PredId] = true;
+          ++NumPending;
+        }
+      }
+    }
+  }
+}
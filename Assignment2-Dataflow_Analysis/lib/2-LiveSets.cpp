@@ -0,0 +1,99 @@
+#include "DFA.h"
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+
+#include <unistd.h>
+
+using namespace llvm;
+using dfa::PackedBitVector;
+
+void LiveSets::initialize(const Function &F) {
+  VarIds.clear();
+  Vars.clear();
+  BBIds.clear();
+  BBs.clear();
+  NumBBVisits = 0;
+
+  // Only the values that are used somewhere can ever be live.
+  auto AddVar = [&](const Value &Val) {
+    if (!Val.use_empty()) {
+      VarIds.try_emplace(&Val, Vars.size());
+      Vars.push_back(&Val);
+    }
+  };
+  for (const Argument &Arg : F.args()) {
+    AddVar(Arg);
+  }
+  for (const Instruction &Inst : instructions(F)) {
+    AddVar(Inst);
+  }
+
+  // Number the blocks in post-order, so that the successors come before
+  // their predecessors, followed by the blocks that are unreachable from the
+  // entry.
+  for (const BasicBlock *const BB : post_order(&F.getEntryBlock())) {
+    BBIds.try_emplace(BB, BBs.size());
+    BBs.push_back(BB);
+  }
+  for (const BasicBlock &BB : F) {
+    if (BBIds.try_emplace(&BB, BBs.size()).second) {
+      BBs.push_back(&BB);
+    }
+  }
+  LiveIns.assign(BBs.size(), PackedBitVector(Vars.size()));
+  LiveOuts.assign(BBs.size(), PackedBitVector(Vars.size()));
+}
+
+bool LiveSets::isLiveAt(const Value *const Val, const Instruction &Inst) const {
+  if (getVarId(Val) == NoVarId) {
+    return false;
+  }
+  const BasicBlock &BB = *Inst.getParent();
+  for (const Instruction &Next : make_range(Inst.getIterator(), BB.end())) {
+    if (&Next == Val) {
+      return false;
+    }
+    if (!isa<PHINode>(Next) && is_contained(Next.operands(), Val)) {
+      return true;
+    }
+  }
+  return isLiveOut(Val, BB);
+}
+
+void LiveSets::print(const Function &F) const {
+  if (dfa::DumpVerbosity == dfa::Verbosity::None) {
+    return;
+  }
+  // errs() is unbuffered, hence write through a buffered stream on the same
+  // file descriptor instead.
+  errs().flush();
+  raw_fd_ostream Errs(STDERR_FILENO, /*shouldClose=*/false);
+  ModuleSlotTracker MST(F.getParent());
+  MST.incorporateFunction(F);
+  const std::string Prefix = "CHECK: [" + getName() + "] ";
+
+  auto PrintVars = [&](const PackedBitVector &Live) {
+    Errs << Prefix << "\t{";
+    for (size_t VarId = 0; VarId < Vars.size(); ++VarId) {
+      if (Live.test(VarId)) {
+        dfa::Variable(Vars[VarId]).print(Errs, MST);
+        Errs << ", ";
+      }
+    }
+    Errs << "}\n";
+  };
+  if (dfa::DumpVerbosity >= dfa::Verbosity::Block) {
+    for (const BasicBlock &BB : F) {
+      const unsigned BBId = BBIds.lookup(&BB);
+      Errs << "\n";
+      PrintVars(LiveIns[BBId]);
+      PrintVars(LiveOuts[BBId]);
+    }
+  }
+  Errs << Prefix << "Converged after " << NumBBVisits
+       << " basic block visits\n";
+}
@@ -10,76 +10,71 @@ void Liveness::initializeDomainFromInst(const llvm::Instruction &Inst) {
   for (const auto &Op : Inst.operands()) {
     /* Only care the instruction-define value and Argument */
     if (isa<Instruction>(Op) || isa<Argument>(Op)) {
-      dfa::Variable VAR(Op);
-      if (DomainIdMap.count(VAR) == 0) {
-        DomainVector.push_back(VAR);
-        DomainIdMap.insert(std::make_pair(VAR, DomainVector.size() - 1));
-      }
+      internDomainElem(dfa::Variable(Op), Op);
     }
   }
 }
 
-bool Liveness::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
-                             DomainVal_t &ODV) {
-
-  /// @todo(CSCD70) Please complete this method.
-  DomainVal_t Tmp = IDV;
+void Liveness::initializeInstDomainIds(const Instruction &Inst,
+                                       const ContainingIds_t &ContainingIds,
+                                       InstDomainIds &Ids) {
+  BackwardAnalysis_t::initializeInstDomainIds(Inst, ContainingIds, Ids);
 
   //如果该BasicBlock中含有br，我们要额外处理(会合并到phi指令中)
   //如果phi指令中的value并不是来自本BasicBlock中，我们可以认为在本BasicBlock中该Value不活跃
   //想想把，如果该value不在本BasicBlock中，自然可以设置该Value为不活跃
   //如果该Value是本次处理的Instruction，通过transfer可以设置为活跃，处理结果没有问题
   const llvm::BasicBlock *parent = Inst.getParent();
-  const Instruction *BR = parent->getTerminator();
+  // The incoming values are the same for every instruction of the block, so
+  // they are only collected when visiting its first instruction.
+  if (&Inst == &parent->front()) {
+    PHIKills.clear();
+    const Instruction *BR = parent->getTerminator();
 
-  if(BR){
-    unsigned NumberOfSuccessor = BR->getNumSuccessors();
-    for(unsigned idx = 0; idx < NumberOfSuccessor; ++idx){
-      const llvm::BasicBlock *Successor = BR->getSuccessor(idx);
+    if(BR){
+      unsigned NumberOfSuccessor = BR->getNumSuccessors();
+      for(unsigned idx = 0; idx < NumberOfSuccessor; ++idx){
+        const llvm::BasicBlock *Successor = BR->getSuccessor(idx);
 
-      for(const Instruction &I : *Successor){
-        if(I.getOpcode() == Instruction::PHI){ //phi指令只在开头
+        for(const Instruction &I : *Successor){
+          if(I.getOpcode() == Instruction::PHI){ //phi指令只在开头
 
-          const llvm::PHINode *node = dyn_cast<llvm::PHINode>(&I);
-          unsigned Number = node->getNumIncomingValues();
-          for(unsigned i = 0; i < Number; ++i){
-            const llvm::BasicBlock *prev = node->getIncomingBlock(i);
-            if(prev != parent){
-              auto value = node->getIncomingValue(i);
-              auto iter = DomainIdMap.find(value);
-              if(iter != DomainIdMap.end()){
-                Tmp[iter->second].Value = false;
+            const llvm::PHINode *node = dyn_cast<llvm::PHINode>(&I);
+            unsigned Number = node->getNumIncomingValues();
+            for(unsigned i = 0; i < Number; ++i){
+              const llvm::BasicBlock *prev = node->getIncomingBlock(i);
+              if(prev != parent){
+                const size_t VarId = getDomainId(node->getIncomingValue(i));
+                if (VarId != NoDomainId) {
+                  PHIKills.push_back(VarId);
+                }
               }
             }
+          }else{
+            break;
           }
-        }else{
-          break;
         }
       }
     }
   }
-  // gen U (IN - def)
-
-  const Value *ValueInst = dyn_cast<llvm::Value>(&Inst);
+  Ids.Kills.append(PHIKills.begin(), PHIKills.end());
+}
 
-  for(auto &Var : DomainVector){
-    if(Var.Var == ValueInst){
-      Tmp[DomainIdMap.find(Var)->second].Value = false;
-    }  
-  }
+bool Liveness::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
+                             DomainVal_t &ODV) {
 
-  for(auto &Op : Inst.operands()){
-    if(isa<Instruction>(Op) || isa<Argument>(Op)){
-      Tmp[DomainIdMap.find(dfa::Variable(Op))->second].Value = true;
-    }
-  }
+  /// @todo(CSCD70) Please complete this method.
+  DomainVal_t &Tmp = TransferBuf;
+  Tmp = IDV;
 
-  for(std::size_t i = 0; i < Tmp.size(); ++i){
-    if(Tmp[i].Value != ODV[i].Value){
-      ODV = Tmp;
-      return true;
+  // gen U (IN - def)
+  const InstDomainIds &Ids = getInstDomainIds(Inst);
+  applyKills(Inst, Ids, Tmp);
+  for (const size_t VarId : Ids.Uses) {
+    if (VarId != NoDomainId) {
+      Tmp.set(VarId);
     }
   }
 
-  return false;
+  return updateODV(ODV);
 }
@@ -0,0 +1,83 @@
+#include "DFA.h"
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Format.h>
+
+#include <chrono>
+#include <string>
+
+using namespace llvm;
+using dfa::PackedBitVector;
+
+namespace {
+
+std::string getOperandName(const Value &Val) {
+  std::string Name;
+  raw_string_ostream OS(Name);
+  Val.printAsOperand(OS, /*PrintType=*/false);
+  return OS.str();
+}
+
+} // anonymous namespace
+
+PreservedAnalyses LivenessCheckPass::run(Module &M, ModuleAnalysisManager &) {
+  using Clock_t = std::chrono::steady_clock;
+  std::chrono::duration<double, std::milli> IterativeTime(0), SSATime(0);
+  size_t NumFuncs = 0, NumBBs = 0, NumMismatches = 0;
+  size_t NumIterativeVisits = 0, NumSSAVisits = 0;
+
+  for (const Function &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    ++NumFuncs;
+    NumBBs += F.size();
+    BlockLiveness Iterative;
+    SSALiveness SSA;
+    const auto Begin = Clock_t::now();
+    Iterative.solve(F);
+    const auto Mid = Clock_t::now();
+    SSA.solve(F);
+    IterativeTime += Mid - Begin;
+    SSATime += Clock_t::now() - Mid;
+    NumIterativeVisits += Iterative.getNumBBVisits();
+    NumSSAVisits += SSA.getNumBBVisits();
+
+    // Both engines number the variables in the same way.
+    CHECK(Iterative.getVars() == SSA.getVars())
+        << "Liveness engines disagree on the variables of " << F.getName();
+    const std::vector<const Value *> &Vars = Iterative.getVars();
+    auto Compare = [&](const BasicBlock &BB, const PackedBitVector &Expected,
+                       const PackedBitVector &Actual, const char *Kind) {
+      if (Expected == Actual) {
+        return;
+      }
+      for (size_t VarId = 0; VarId < Vars.size(); ++VarId) {
+        if (Expected.test(VarId) == Actual.test(VarId)) {
+          continue;
+        }
+        ++NumMismatches;
+        LOG_ANALYSIS_INFO << "@" << F.getName() << ": "
+                          << getOperandName(*Vars[VarId]) << " is "
+                          << (Expected.test(VarId) ? "" : "not ") << Kind
+                          << " of " << getOperandName(BB)
+                          << " in BlockLiveness but "
+                          << (Actual.test(VarId) ? "" : "not ")
+                          << "in SSALiveness";
+      }
+    };
+    for (const BasicBlock &BB : F) {
+      Compare(BB, Iterative.getLiveIn(BB), SSA.getLiveIn(BB), "live in");
+      Compare(BB, Iterative.getLiveOut(BB), SSA.getLiveOut(BB), "live out");
+    }
+  }
+
+  LOG_ANALYSIS_INFO << "Checked " << NumFuncs << " functions (" << NumBBs
+                    << " basic blocks), " << NumMismatches << " mismatches";
+  LOG_ANALYSIS_INFO << "BlockLiveness: "
+                    << format("%.3f", IterativeTime.count()) << " ms, "
+                    << NumIterativeVisits << " basic block visits";
+  LOG_ANALYSIS_INFO << "SSALiveness: " << format("%.3f", SSATime.count())
+                    << " ms, " << NumSSAVisits << " basic block visits";
+  return PreservedAnalyses::all();
+}
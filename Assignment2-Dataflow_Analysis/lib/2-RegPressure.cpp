@@ -0,0 +1,178 @@
+#include "DFA.h"
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/Support/Format.h>
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using dfa::PackedBitVector;
+
+namespace {
+
+/// @brief Half-open range of instruction slots.
+struct Segment {
+  unsigned Begin, End;
+};
+
+/// @brief Slots at which a variable is live, as one segment per block.
+struct LiveInterval {
+  const Value *Var = nullptr;
+  SmallVector<Segment, 2> Segments;
+};
+
+struct PressureStats {
+  unsigned Max = 0;
+  uint64_t Sum = 0;
+  size_t NumSlots = 0;
+
+  void add(const unsigned Pressure) {
+    Max = std::max(Max, Pressure);
+    Sum += Pressure;
+    ++NumSlots;
+  }
+  void add(const PressureStats &Other) {
+    Max = std::max(Max, Other.Max);
+    Sum += Other.Sum;
+    NumSlots += Other.NumSlots;
+  }
+  double getAverage() const {
+    return NumSlots == 0 ? 0.0 : static_cast<double>(Sum) / NumSlots;
+  }
+};
+
+} // anonymous namespace
+
+PreservedAnalyses RegPressurePass::run(Function &F,
+                                       FunctionAnalysisManager &FAM) {
+  const BlockLiveness &Live = FAM.getResult<BlockLiveness>(F).get();
+  const LoopInfo &LI = FAM.getResult<LoopAnalysis>(F);
+
+  // Linearize the reachable blocks. Every instruction takes one slot, and
+  // every block the range of the slots of its instructions.
+  std::vector<const BasicBlock *> Order;
+  DenseMap<const BasicBlock *, Segment> BBSlots;
+  unsigned NumSlots = 0;
+  for (const BasicBlock *const BB :
+       ReversePostOrderTraversal<const Function *>(&F)) {
+    Order.push_back(BB);
+    BBSlots[BB] = {.Begin = NumSlots,
+                   .End = NumSlots + static_cast<unsigned>(BB->size())};
+    NumSlots += BB->size();
+  }
+
+  const std::vector<const Value *> &Vars = Live.getVars();
+  DenseMap<const Value *, unsigned> VarIds;
+  std::vector<LiveInterval> Intervals(Vars.size());
+  for (unsigned VarId = 0; VarId < Vars.size(); ++VarId) {
+    VarIds[Vars[VarId]] = VarId;
+    Intervals[VarId].Var = Vars[VarId];
+  }
+
+  // Build the segment of every variable that is live in each block, from its
+  // definition (or the start of the block if it is live in) to its last use
+  // (or the end of the block if it is live out).
+  size_t NumSegments = 0;
+  DenseMap<unsigned, unsigned> DefSlots, UseEnds;
+  for (const BasicBlock *const BB : Order) {
+    const Segment Range = BBSlots.lookup(BB);
+    DefSlots.clear();
+    UseEnds.clear();
+    unsigned Slot = Range.Begin;
+    for (const Instruction &Inst : *BB) {
+      // The incoming values of PHI nodes are live out of the predecessors.
+      if (!isa<PHINode>(Inst)) {
+        for (const Value *const Op : Inst.operands()) {
+          const auto Iter = VarIds.find(Op);
+          if (Iter != VarIds.end()) {
+            UseEnds[Iter->second] = Slot + 1;
+          }
+        }
+      }
+      const auto Iter = VarIds.find(&Inst);
+      if (Iter != VarIds.end()) {
+        DefSlots[Iter->second] = Slot;
+      }
+      ++Slot;
+    }
+    auto AddSegment = [&](const unsigned VarId, const unsigned End) {
+      const auto DefIter = DefSlots.find(VarId);
+      const unsigned Begin =
+          DefIter == DefSlots.end() ? Range.Begin : DefIter->second;
+      Intervals[VarId].Segments.push_back({.Begin = Begin, .End = End});
+      ++NumSegments;
+    };
+    const PackedBitVector &LiveOut = Live.getLiveOut(*BB);
+    for (size_t VarId = LiveOut.findNext(0); VarId != LiveOut.size();
+         VarId = LiveOut.findNext(VarId + 1)) {
+      AddSegment(VarId, Range.End);
+    }
+    for (const auto &VarUseEnd : UseEnds) {
+      if (!LiveOut.test(VarUseEnd.first)) {
+        AddSegment(VarUseEnd.first, VarUseEnd.second);
+      }
+    }
+    // Definitions whose only uses are in unreachable blocks.
+    for (const auto &VarDef : DefSlots) {
+      if (!LiveOut.test(VarDef.first) && UseEnds.count(VarDef.first) == 0) {
+        AddSegment(VarDef.first, VarDef.second + 1);
+      }
+    }
+  }
+
+  // The pressure at every slot is the number of segments that cover it.
+  std::vector<int> Deltas(NumSlots + 1, 0);
+  for (const LiveInterval &Interval : Intervals) {
+    for (const Segment &Seg : Interval.Segments) {
+      ++Deltas[Seg.Begin];
+      --Deltas[Seg.End];
+    }
+  }
+  DenseMap<const BasicBlock *, PressureStats> BBStats;
+  PressureStats FuncStats;
+  int Pressure = 0;
+  for (const BasicBlock *const BB : Order) {
+    const Segment Range = BBSlots.lookup(BB);
+    PressureStats &Stats = BBStats[BB];
+    for (unsigned Slot = Range.Begin; Slot < Range.End; ++Slot) {
+      Pressure += Deltas[Slot];
+      Stats.add(Pressure);
+    }
+    FuncStats.add(Stats);
+  }
+
+  ModuleSlotTracker MST(F.getParent());
+  MST.incorporateFunction(F);
+  auto GetName = [&](const BasicBlock &BB) {
+    std::string Name;
+    raw_string_ostream OS(Name);
+    BB.printAsOperand(OS, /*PrintType=*/false, MST);
+    return OS.str();
+  };
+  LOG_ANALYSIS_INFO << "@" << F.getName() << ": " << Intervals.size()
+                    << " live intervals (" << NumSegments
+                    << " segments) over " << NumSlots
+                    << " instructions, max pressure " << FuncStats.Max
+                    << ", average " << format("%.2f", FuncStats.getAverage());
+  for (const Loop *const L : LI.getLoopsInPreorder()) {
+    PressureStats Stats;
+    for (const BasicBlock *const BB : L->blocks()) {
+      Stats.add(BBStats.lookup(BB));
+    }
+    LOG_ANALYSIS_INFO << "Loop " << GetName(*L->getHeader()) << " (depth "
+                      << L->getLoopDepth() << "): max pressure " << Stats.Max
+                      << ", average " << format("%.2f", Stats.getAverage());
+  }
+  if (dfa::DumpVerbosity >= dfa::Verbosity::Block) {
+    for (const BasicBlock *const BB : Order) {
+      const PressureStats &Stats = BBStats[BB];
+      LOG_ANALYSIS_INFO << "Block " << GetName(*BB) << ": max pressure "
+                        << Stats.Max << ", average "
+                        << format("%.2f", Stats.getAverage());
+    }
+  }
+  return PreservedAnalyses::all();
+}
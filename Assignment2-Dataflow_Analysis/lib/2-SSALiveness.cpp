@@ -0,0 +1,65 @@
+#include "DFA.h"
+
+#include <llvm/IR/CFG.h>
+
+#include <vector>
+
+using namespace llvm;
+using dfa::PackedBitVector;
+
+AnalysisKey SSALiveness::Key;
+
+void SSALiveness::exploreUses(const size_t VarId,
+                              std::vector<const BasicBlock *> &Worklist) {
+  const Value *const Var = Vars[VarId];
+  const auto *const Def = dyn_cast<Instruction>(Var);
+  // Arguments are defined before the entry block.
+  const BasicBlock *const DefBB = Def != nullptr ? Def->getParent() : nullptr;
+
+  auto MarkLiveIn = [&](const BasicBlock *const BB) {
+    PackedBitVector &LiveIn = LiveIns[BBIds.lookup(BB)];
+    if (!LiveIn.test(VarId)) {
+      LiveIn.set(VarId);
+      Worklist.push_back(BB);
+    }
+  };
+  auto MarkLiveOut = [&](const BasicBlock *const BB) {
+    PackedBitVector &LiveOut = LiveOuts[BBIds.lookup(BB)];
+    if (!LiveOut.test(VarId)) {
+      LiveOut.set(VarId);
+      if (BB != DefBB) {
+        MarkLiveIn(BB);
+      }
+    }
+  };
+
+  for (const Use &U : Var->uses()) {
+    const auto *const User = cast<Instruction>(U.getUser());
+    if (const auto *const PHI = dyn_cast<PHINode>(User)) {
+      MarkLiveOut(PHI->getIncomingBlock(U));
+      continue;
+    }
+    // Uses that come before the definition only appear in unreachable code,
+    // where they make the variable live into its own block.
+    const BasicBlock *const UserBB = User->getParent();
+    if (UserBB != DefBB || User == Def || User->comesBefore(Def)) {
+      MarkLiveIn(UserBB);
+    }
+  }
+  while (!Worklist.empty()) {
+    const BasicBlock *const BB = Worklist.back();
+    Worklist.pop_back();
+    ++NumBBVisits;
+    for (const BasicBlock *const Pred : predecessors(BB)) {
+      MarkLiveOut(Pred);
+    }
+  }
+}
+
+void SSALiveness::solve(const Function &F) {
+  initialize(F);
+  std::vector<const BasicBlock *> Worklist;
+  for (size_t VarId = 0; VarId < Vars.size(); ++VarId) {
+    exploreUses(VarId, Worklist);
+  }
+}
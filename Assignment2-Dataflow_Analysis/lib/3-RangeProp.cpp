@@ -0,0 +1,210 @@
+#include "DFA.h"
+
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#include <utility>
+#include <vector>
+
+using namespace llvm;
+using dfa::RangeValue;
+
+AnalysisKey RangeProp::Key;
+
+void RangeProp::initializeDomainFromInst(const Instruction &Inst) {
+  // Only integer instructions have a range. Arguments and other values are
+  // not part of the domain, and always take the full range.
+  if (Inst.getType()->isIntegerTy()) {
+    internDomainElem(dfa::Variable(&Inst), &Inst);
+  }
+}
+
+RangeValue RangeProp::getOperandRange(const Value *const Op,
+                                      const size_t DomainId,
+                                      const DomainVal_t &DV) const {
+  if (const auto *const CI = dyn_cast<ConstantInt>(Op)) {
+    return RangeValue(ConstantRange(CI->getValue()));
+  }
+  if (DomainId != NoDomainId) {
+    return DV[DomainId];
+  }
+  return RangeValue::getFull(Op->getType()->getIntegerBitWidth());
+}
+
+void RangeProp::refineWithBranchCond(const BasicBlock &BB,
+                                     DomainVal_t &DV) const {
+  const BasicBlock *const Pred = BB.getSinglePredecessor();
+  if (Pred == nullptr) {
+    return;
+  }
+  const auto *const BI = dyn_cast<BranchInst>(Pred->getTerminator());
+  if (BI == nullptr || !BI->isConditional() ||
+      BI->getSuccessor(0) == BI->getSuccessor(1)) {
+    return;
+  }
+  const auto *const ICmp = dyn_cast<ICmpInst>(BI->getCondition());
+  if (ICmp == nullptr || !ICmp->getOperand(0)->getType()->isIntegerTy()) {
+    return;
+  }
+  const CmpInst::Predicate Pred0 = BI->getSuccessor(0) == &BB
+                                       ? ICmp->getPredicate()
+                                       : ICmp->getInversePredicate();
+  const Value *const LHS = ICmp->getOperand(0),
+              *const RHS = ICmp->getOperand(1);
+  const size_t LHSId = getDomainId(LHS), RHSId = getDomainId(RHS);
+  const RangeValue L = getOperandRange(LHS, LHSId, DV),
+                   R = getOperandRange(RHS, RHSId, DV);
+  if (L.isUndef() || R.isUndef()) {
+    return;
+  }
+  if (LHSId != NoDomainId) {
+    DV[LHSId] = RangeValue(L.getRange().intersectWith(
+        ConstantRange::makeAllowedICmpRegion(Pred0, R.getRange())));
+  }
+  if (RHSId != NoDomainId) {
+    DV[RHSId] = RangeValue(R.getRange().intersectWith(
+        ConstantRange::makeAllowedICmpRegion(
+            CmpInst::getSwappedPredicate(Pred0), L.getRange())));
+  }
+}
+
+bool RangeProp::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
+                             DomainVal_t &ODV) {
+  DomainVal_t &Tmp = TransferBuf;
+  Tmp = IDV;
+
+  // The condition of the incoming edge holds throughout the block.
+  if (&Inst == &Inst.getParent()->front()) {
+    refineWithBranchCond(*Inst.getParent(), Tmp);
+  }
+  const InstDomainIds &Ids = getInstDomainIds(Inst);
+  if (Ids.Def == NoDomainId) {
+    return updateODV(ODV);
+  }
+  auto GetOperandRange = [&](const unsigned Idx) {
+    return getOperandRange(Inst.getOperand(Idx), Ids.Uses[Idx], Tmp);
+  };
+  const unsigned BitWidth = Inst.getType()->getIntegerBitWidth();
+
+  RangeValue Res = RangeValue::getFull(BitWidth);
+  if (const auto *const PHI = dyn_cast<PHINode>(&Inst)) {
+    // Values that have not reached the PHI node yet are skipped.
+    Res = RangeValue::getUndef();
+    for (unsigned Idx = 0; Idx < PHI->getNumIncomingValues(); ++Idx) {
+      Res = MeetOp.ValueMeet(Res, GetOperandRange(Idx));
+    }
+  } else if (const auto *const BO = dyn_cast<BinaryOperator>(&Inst)) {
+    const RangeValue L = GetOperandRange(0), R = GetOperandRange(1);
+    if (L.isUndef() || R.isUndef()) {
+      Res = RangeValue::getUndef();
+    } else if (isa<OverflowingBinaryOperator>(BO)) {
+      const auto *const OBO = cast<OverflowingBinaryOperator>(BO);
+      unsigned NoWrapKind = 0;
+      if (OBO->hasNoUnsignedWrap()) {
+        NoWrapKind |= OverflowingBinaryOperator::NoUnsignedWrap;
+      }
+      if (OBO->hasNoSignedWrap()) {
+        NoWrapKind |= OverflowingBinaryOperator::NoSignedWrap;
+      }
+      Res = RangeValue(L.getRange().overflowingBinaryOp(
+          BO->getOpcode(), R.getRange(), NoWrapKind));
+    } else {
+      Res = RangeValue(L.getRange().binaryOp(BO->getOpcode(), R.getRange()));
+    }
+  } else if (const auto *const Cast = dyn_cast<CastInst>(&Inst)) {
+    if (Cast->getSrcTy()->isIntegerTy()) {
+      const RangeValue Src = GetOperandRange(0);
+      Res = Src.isUndef() ? Src
+                          : RangeValue(Src.getRange().castOp(Cast->getOpcode(),
+                                                             BitWidth));
+    }
+  } else if (const auto *const ICmp = dyn_cast<ICmpInst>(&Inst)) {
+    if (ICmp->getOperand(0)->getType()->isIntegerTy()) {
+      const RangeValue L = GetOperandRange(0), R = GetOperandRange(1);
+      if (L.isUndef() || R.isUndef()) {
+        Res = RangeValue::getUndef();
+      } else if (L.getRange().icmp(ICmp->getPredicate(), R.getRange())) {
+        Res = RangeValue(ConstantRange(APInt(1, 1)));
+      } else if (L.getRange().icmp(ICmp->getInversePredicate(),
+                                   R.getRange())) {
+        Res = RangeValue(ConstantRange(APInt(1, 0)));
+      }
+    }
+  } else if (isa<SelectInst>(&Inst) &&
+             Inst.getOperand(0)->getType()->isIntegerTy()) {
+    const RangeValue Cond = GetOperandRange(0);
+    const APInt *const CondVal =
+        Cond.isUndef() ? nullptr : Cond.getRange().getSingleElement();
+    if (Cond.isUndef()) {
+      Res = Cond;
+    } else if (CondVal != nullptr) {
+      Res = GetOperandRange(CondVal->isZero() ? 2 : 1);
+    } else {
+      Res = MeetOp.ValueMeet(GetOperandRange(1), GetOperandRange(2));
+    }
+  }
+  Tmp[Ids.Def] = std::move(Res);
+  return updateODV(ODV);
+}
+
+RangeProp::RangeTable_t RangeProp::computeRangeTable(const Function &F,
+                                                     Result &Ranges) {
+  RangeTable_t Table;
+  for (const BasicBlock &BB : F) {
+    for (const Instruction &Inst : BB) {
+      const size_t DomainId = Ranges.getDomainId(&Inst);
+      if (DomainId == NoDomainId) {
+        continue;
+      }
+      const RangeValue Val = Ranges.getOut(Inst)[DomainId];
+      if (!Val.isUndef()) {
+        Table.try_emplace(&Inst, Val.getRange());
+      }
+    }
+  }
+  return Table;
+}
+
+PreservedAnalyses RangePropRewritePass::run(Function &F,
+                                            FunctionAnalysisManager &FAM) {
+  const RangeProp::RangeTable_t Table =
+      RangeProp::computeRangeTable(F, FAM.getResult<RangeProp>(F));
+
+  std::vector<std::pair<BranchInst *, BasicBlock *>> FoldedBranches;
+  size_t NumCondBranches = 0;
+  for (BasicBlock &BB : F) {
+    auto *const BI = dyn_cast<BranchInst>(BB.getTerminator());
+    if (BI == nullptr || !BI->isConditional()) {
+      continue;
+    }
+    ++NumCondBranches;
+    const auto Iter = Table.find(BI->getCondition());
+    const APInt *const CondVal =
+        Iter == Table.end() ? nullptr : Iter->second.getSingleElement();
+    if (CondVal != nullptr && BI->getSuccessor(0) != BI->getSuccessor(1)) {
+      FoldedBranches.emplace_back(BI,
+                                  BI->getSuccessor(CondVal->isZero() ? 1 : 0));
+    }
+  }
+  for (const auto &BranchTarget : FoldedBranches) {
+    BranchInst *const BI = BranchTarget.first;
+    BasicBlock *const Untaken =
+        BI->getSuccessor(BI->getSuccessor(0) == BranchTarget.second ? 1 : 0);
+    Untaken->removePredecessor(BI->getParent());
+    BranchInst::Create(BranchTarget.second, BI);
+    BI->eraseFromParent();
+  }
+  const size_t NumBBs = F.size();
+  if (!FoldedBranches.empty()) {
+    removeUnreachableBlocks(F);
+  }
+
+  LOG_ANALYSIS_INFO << "Folded " << FoldedBranches.size() << " out of "
+                    << NumCondBranches << " conditional branches, erased "
+                    << NumBBs - F.size() << " unreachable basic blocks";
+
+  return FoldedBranches.empty() ? PreservedAnalyses::all()
+                                : PreservedAnalyses::none();
+}
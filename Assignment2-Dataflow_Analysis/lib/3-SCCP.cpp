@@ -1,229 +1,353 @@
 #include "DFA.h"
-#include "../include/DFA/Domain/Variable.h"
-#include "../include/DFA/Flow/Framework.h"
-#include "../include/DFA/MeetOp.h"
-#include "llvm/IR/InstrTypes.h"
+
+#include <DFA/ConstFolding.h>
+
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+
+#include <utility>
+#include <vector>
+#include <unistd.h>
 
 using namespace llvm;
+using dfa::ConstValue;
 
 AnalysisKey SCCP::Key;
 
-void SCCP::initializeDomainFromInst(const llvm::Instruction &Inst) {
-  if(!(&Inst)->getType()->isVoidTy()){
-    dfa::Variable VAR(&Inst);
-    if(DomainIdMap.count(VAR) == 0){
-      DomainVector.push_back(VAR);
-      DomainIdMap.insert(std::make_pair(VAR, DomainVector.size() - 1));
-    }
+ConstValue SCCP::getLatticeValue(const Value *const Val) const {
+  if (const auto *const CI = dyn_cast<ConstantInt>(Val)) {
+    return ConstValue::getConst(CI->getValue());
   }
-
-  for (const auto &Op : Inst.operands()) {
-    /* Only care the instruction-define value and Argument */
-    if (isa<Instruction>(Op) || isa<Argument>(Op)) {
-      dfa::Variable VAR(Op);
-      if (DomainIdMap.count(VAR) == 0) {
-        DomainVector.push_back(VAR);
-        DomainIdMap.insert(std::make_pair(VAR, DomainVector.size() - 1));
-      }
-    }
+  if (isa<Instruction>(Val)) {
+    const auto Iter = Cells.find(Val);
+    return Iter == Cells.end() ? ConstValue::getUndef() : Iter->second;
   }
+  return ConstValue::getNac();
 }
 
-void SCCP::handleBO(const Instruction &Inst, const DomainVal_t &IDV, dfa::ConstValue &res){
-  Value *op1 = Inst.getOperand(0);
-  Value *op2 = Inst.getOperand(1);
-
-  int64_t ConstVal1, ConstVal2;
-  if(isa<llvm::ConstantInt>(op2)){
-    ConstVal2 = dyn_cast<llvm::ConstantInt>(op2)->getSExtValue();
-  }else{
-    dfa::Variable var2 = dfa::Variable(op2);
-    if(!IDV[DomainIdMap.find(var2)->second].isConst()){
-      res = IDV[DomainIdMap.find(var2)->second];
-      return;
-    }
-    ConstVal2 = IDV[DomainIdMap.find(var2)->second].getConst();
-  }
-
-  if(isa<llvm::ConstantInt>(op1)){
-    ConstVal1 = dyn_cast<llvm::ConstantInt>(op1)->getSExtValue();
-  }else{
-    dfa::Variable var1 = dfa::Variable(op1);
-    if(!IDV[DomainIdMap.find(var1)->second].isConst() && ConstVal2 == 0){
-      switch(Inst.getOpcode()){
-        case Instruction::SDiv:
-          res = dfa::ConstValue::getUndef();
-          return;
-        default:
-          res = dfa::ConstValue::getNac();
-         return;
-      }
-    }else if(!IDV[DomainIdMap.find(var1)->second].isConst()){
-      res = IDV[DomainIdMap.find(var1)->second];
-      return;
-    }
-    ConstVal1 = IDV[DomainIdMap.find(var1)->second].getConst();
-  }
-
-  switch(Inst.getOpcode()){
-    case Instruction::Add:
-      res = dfa::ConstValue::getConst(ConstVal1 + ConstVal2);
-      break;
-    case Instruction::Sub:
-      res = dfa::ConstValue::getConst(ConstVal1 - ConstVal2);
-      break;
-    case Instruction::Mul:
-      res = dfa::ConstValue::getConst(ConstVal1 * ConstVal2);
-      break;
-    case Instruction::SDiv:
-      res = dfa::ConstValue::getConst(ConstVal1 / ConstVal2);
-      break;
-    default: 
-      // @Todo
-      break;
-  }
-
-  return;
+void SCCP::markEdgeExecutable(const BasicBlock *const From,
+                              const BasicBlock *const To) {
+  if (ExecutableEdges.insert({From, To}).second) {
+    CFGWorklist.push_back({From, To});
+  }
 }
 
+void SCCP::updateCell(const Instruction &Inst, const ConstValue &Val) {
+  const ConstValue Old = getLatticeValue(&Inst);
+  // Meeting with the old value keeps the cells monotone, hence every cell
+  // changes at most twice.
+  const ConstValue New = MeetOp.ValueMeet(Old, Val);
+  if (New != Old) {
+    Cells[&Inst] = New;
+    SSAWorklist.push_back(&Inst);
+  }
+}
 
-void SCCP::handleCMP(const Instruction &Inst, const DomainVal_t &IDV, dfa::ConstValue &res){
-  Value *op1 = Inst.getOperand(0);
-  Value *op2 = Inst.getOperand(1);
+ConstValue SCCP::foldBinaryOp(const BinaryOperator &BO) const {
+  const ConstValue LHS = getLatticeValue(BO.getOperand(0)),
+                   RHS = getLatticeValue(BO.getOperand(1));
+  if (LHS.isNac() || RHS.isNac()) {
+    return ConstValue::getNac();
+  }
+  if (LHS.isUndef() || RHS.isUndef()) {
+    return ConstValue::getUndef();
+  }
+  // Undefined behavior (e.g., a division by zero) is left to the execution
+  // rather than folded.
+  APInt Res;
+  return dfa::foldBinaryOp(BO.getOpcode(), LHS.getConst(), RHS.getConst(), Res)
+             ? ConstValue::getConst(std::move(Res))
+             : ConstValue::getNac();
+}
 
-  int64_t ConstVal1, ConstVal2;
-  if(isa<llvm::ConstantInt>(op2)){
-    ConstVal2 = dyn_cast<llvm::ConstantInt>(op2)->getSExtValue();
-  }else{
-    dfa::Variable var2 = dfa::Variable(op2);
-    if(!IDV[DomainIdMap.find(var2)->second].isConst()){
-      res = IDV[DomainIdMap.find(var2)->second];
-      return;
-    }
-    ConstVal2 = IDV[DomainIdMap.find(var2)->second].getConst();
+ConstValue SCCP::foldCast(const CastInst &Cast) const {
+  const ConstValue Src = getLatticeValue(Cast.getOperand(0));
+  if (!Src.isConst() || !Cast.getType()->isIntegerTy()) {
+    return Src.isUndef() ? Src : ConstValue::getNac();
   }
+  APInt Res;
+  return dfa::foldIntCast(Cast.getOpcode(), Src.getConst(),
+                          Cast.getType()->getIntegerBitWidth(), Res)
+             ? ConstValue::getConst(std::move(Res))
+             : ConstValue::getNac();
+}
 
-  if(isa<llvm::ConstantInt>(op1)){
-    ConstVal1 = dyn_cast<llvm::ConstantInt>(op1)->getSExtValue();
-  }else{
-    dfa::Variable var1 = dfa::Variable(op1);
-    if(!IDV[DomainIdMap.find(var1)->second].isConst()){
-      res = IDV[DomainIdMap.find(var1)->second];
-      return;
-    }
-    ConstVal1 = IDV[DomainIdMap.find(var1)->second].getConst();
+ConstValue SCCP::foldICmp(const ICmpInst &ICmp) const {
+  const ConstValue LHS = getLatticeValue(ICmp.getOperand(0)),
+                   RHS = getLatticeValue(ICmp.getOperand(1));
+  if (LHS.isNac() || RHS.isNac()) {
+    return ConstValue::getNac();
   }
+  if (LHS.isUndef() || RHS.isUndef()) {
+    return ConstValue::getUndef();
+  }
+  const bool Res =
+      ICmpInst::compare(LHS.getConst(), RHS.getConst(), ICmp.getPredicate());
+  return ConstValue::getConst(APInt(1, Res));
+}
 
-  switch(Inst.getOpcode()){
-    case CmpInst::Predicate::ICMP_SGT:
-      res = dfa::ConstValue::getConst(ConstVal1 > ConstVal2);
-      break;
-    case CmpInst::Predicate::ICMP_SLT:
-      res = dfa::ConstValue::getConst(ConstVal1 < ConstVal2);
-      break;
-    default: 
-      // @Todo
-      break;
+ConstValue SCCP::foldSelect(const SelectInst &Select) const {
+  const ConstValue Cond = getLatticeValue(Select.getCondition());
+  if (Cond.isUndef()) {
+    return Cond;
   }
-  return;
+  if (Cond.isConst()) {
+    return getLatticeValue(Cond.getConst().isZero() ? Select.getFalseValue()
+                                                    : Select.getTrueValue());
+  }
+  // Either operand may be selected.
+  return MeetOp.ValueMeet(getLatticeValue(Select.getTrueValue()),
+                          getLatticeValue(Select.getFalseValue()));
 }
 
-void SCCP::handlePHI(const Instruction &Inst, const DomainVal_t &IDV, dfa::ConstValue &res){
-  Value *op1 = Inst.getOperand(0);
-  Value *op2 = Inst.getOperand(1);
-
-  int64_t ConstVal1, ConstVal2;
-  if(isa<llvm::ConstantInt>(op2)){
-    ConstVal2 = dyn_cast<llvm::ConstantInt>(op2)->getSExtValue();
-  }else{
-    dfa::Variable var2 = dfa::Variable(op2);
-    if(!IDV[DomainIdMap.find(var2)->second].isConst()){
-      res = IDV[DomainIdMap.find(var2)->second];
-      return;
+void SCCP::visitPHI(const PHINode &PHI) {
+  ConstValue Val = ConstValue::getUndef();
+  for (unsigned Idx = 0; Idx < PHI.getNumIncomingValues(); ++Idx) {
+    if (isEdgeExecutable(*PHI.getIncomingBlock(Idx), *PHI.getParent())) {
+      Val = MeetOp.ValueMeet(Val, getLatticeValue(PHI.getIncomingValue(Idx)));
     }
-    ConstVal2 = IDV[DomainIdMap.find(var2)->second].getConst();
   }
+  updateCell(PHI, Val);
+}
 
-  if(isa<llvm::ConstantInt>(op1)){
-    ConstVal1 = dyn_cast<llvm::ConstantInt>(op1)->getSExtValue();
-  }else{
-    dfa::Variable var1 = dfa::Variable(op1);
-    if(!IDV[DomainIdMap.find(var1)->second].isConst()){
-      res = IDV[DomainIdMap.find(var1)->second];
+void SCCP::visitTerminator(const Instruction &Term) {
+  const BasicBlock *const BB = Term.getParent();
+  const Value *Cond = nullptr;
+  if (const auto *const BI = dyn_cast<BranchInst>(&Term)) {
+    Cond = BI->isConditional() ? BI->getCondition() : nullptr;
+  } else if (const auto *const SI = dyn_cast<SwitchInst>(&Term)) {
+    Cond = SI->getCondition();
+  }
+  const ConstValue CondVal =
+      Cond == nullptr ? ConstValue::getNac() : getLatticeValue(Cond);
+  // No successor is known to be taken until the condition is evaluated.
+  if (CondVal.isUndef()) {
+    return;
+  }
+  if (CondVal.isNac()) {
+    for (const BasicBlock *const Succ : successors(BB)) {
+      markEdgeExecutable(BB, Succ);
+    }
+    return;
+  }
+  if (const auto *const BI = dyn_cast<BranchInst>(&Term)) {
+    markEdgeExecutable(BB,
+                       BI->getSuccessor(CondVal.getConst().isZero() ? 1 : 0));
+    return;
+  }
+  const auto *const SI = cast<SwitchInst>(&Term);
+  for (const auto &Case : SI->cases()) {
+    if (Case.getCaseValue()->getValue() == CondVal.getConst()) {
+      markEdgeExecutable(BB, Case.getCaseSuccessor());
       return;
     }
-    ConstVal1 = IDV[DomainIdMap.find(var1)->second].getConst();
-  }
-
-  switch(Inst.getOpcode()){
-    case Instruction::Add:
-      res = dfa::ConstValue::getConst(ConstVal1 + ConstVal2);
-      break;
-    case Instruction::Sub:
-      res = dfa::ConstValue::getConst(ConstVal1 - ConstVal2);
-      break;
-    case Instruction::Mul:
-      res = dfa::ConstValue::getConst(ConstVal1 * ConstVal2);
-      break;
-    case Instruction::SDiv:
-      res = dfa::ConstValue::getConst(ConstVal1 / ConstVal2);
-      break;
-    default: 
-      // @Todo
-      break;
   }
+  markEdgeExecutable(BB, SI->getDefaultDest());
 }
 
-bool SCCP::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
-                             DomainVal_t &ODV) {
-
-  /// @todo(CSCD70) Please complete this method.
-  DomainVal_t Tmp = IDV;
-
-  // x = 3  ==> {true, 3}
-  // x = y  ==> {IDV[DomainIdMap.find(x)->second] = IDV[DomainIdMap.find(y)->second]}
-  // x = y op z  ==> decided by f(y, z)
-  //           y.isconst && z.isconst    {true, y op z}
-  //f(y , z)   y.isnac || z.isnac        {false, Nac}
-  //           op = /%    z == 0         {false, Undef}
-  
-  // gen U (IN - def)
- if((&Inst)->getType()->isVoidTy())
-    return false;
-
-  const Value *ValueInst = dyn_cast<llvm::Value>(&Inst);
-
-  for(auto &Var : DomainVector){
-    if(Var.Var == ValueInst){
-      Tmp[DomainIdMap.find(Var)->second] = dfa::ConstValue::getUndef();
-    }  
+void SCCP::visitInst(const Instruction &Inst) {
+  ++NumInstVisits;
+  if (const auto *const PHI = dyn_cast<PHINode>(&Inst)) {
+    visitPHI(*PHI);
+    return;
+  }
+  if (Inst.isTerminator()) {
+    visitTerminator(Inst);
+  }
+  if (Inst.getType()->isVoidTy()) {
+    return;
+  }
+  if (const auto *const BO = dyn_cast<BinaryOperator>(&Inst)) {
+    updateCell(Inst, foldBinaryOp(*BO));
+  } else if (const auto *const Cast = dyn_cast<CastInst>(&Inst)) {
+    updateCell(Inst, foldCast(*Cast));
+  } else if (const auto *const ICmp = dyn_cast<ICmpInst>(&Inst)) {
+    updateCell(Inst, foldICmp(*ICmp));
+  } else if (const auto *const Select = dyn_cast<SelectInst>(&Inst)) {
+    updateCell(Inst, foldSelect(*Select));
+  } else {
+    updateCell(Inst, ConstValue::getNac());
   }
+}
 
-  dfa::Variable var(ValueInst);
+void SCCP::solve(const Function &F) {
+  Cells.clear();
+  ExecutableBBs.clear();
+  ExecutableEdges.clear();
+  CFGWorklist.clear();
+  SSAWorklist.clear();
+  NumInstVisits = 0;
 
-  if(isa<BinaryOperator>(&Inst)){
-    handleBO(Inst, Tmp, Tmp[DomainIdMap.find(var)->second]);
+  markEdgeExecutable(nullptr, &F.getEntryBlock());
+  while (!CFGWorklist.empty() || !SSAWorklist.empty()) {
+    while (!CFGWorklist.empty()) {
+      const BasicBlock *const BB = CFGWorklist.back().second;
+      CFGWorklist.pop_back();
+      if (!ExecutableBBs.insert(BB).second) {
+        // Only the PHI nodes depend on which incoming edges are executable.
+        for (const PHINode &PHI : BB->phis()) {
+          ++NumInstVisits;
+          visitPHI(PHI);
+        }
+        continue;
+      }
+      for (const Instruction &Inst : *BB) {
+        visitInst(Inst);
+      }
+    }
+    while (!SSAWorklist.empty()) {
+      const Instruction *const Inst = SSAWorklist.back();
+      SSAWorklist.pop_back();
+      for (const User *const U : Inst->users()) {
+        const auto *const UserInst = dyn_cast<Instruction>(U);
+        if (UserInst != nullptr && isExecutable(*UserInst->getParent())) {
+          visitInst(*UserInst);
+        }
+      }
+    }
   }
+}
 
-  if(isa<ICmpInst>(&Inst)){
-    handleCMP(Inst, Tmp, Tmp[DomainIdMap.find(var)->second]);
+void SCCP::print(const Function &F) const {
+  if (dfa::DumpVerbosity == dfa::Verbosity::None) {
+    return;
   }
+  // errs() is unbuffered, hence write through a buffered stream on the same
+  // file descriptor instead.
+  errs().flush();
+  raw_fd_ostream Errs(STDERR_FILENO, /*shouldClose=*/false);
+  ModuleSlotTracker MST(F.getParent());
+  MST.incorporateFunction(F);
+  const std::string Prefix = "CHECK: [" + getName() + "] ";
 
-  if(isa<PHINode>(&Inst)){
-    //handlePHI(Inst, Tmp, Tmp[DomainIdMap.find(var)->second]); 
-    Tmp[DomainIdMap.find(var)->second] = dfa::ConstValue::getNac();
+  auto PrintCell = [&](const Instruction &Inst) {
+    const ConstValue Val = getLatticeValue(&Inst);
+    if (!Inst.getType()->isVoidTy() && static_cast<bool>(Val)) {
+      dfa::Variable(&Inst).print(Errs, MST);
+      dfa::ValuePrinter<ConstValue>::print(Errs, Val);
+      Errs << ", ";
+    }
+  };
+  if (dfa::DumpVerbosity >= dfa::Verbosity::Block) {
+    for (const BasicBlock &BB : F) {
+      Errs << "\n";
+      if (!isExecutable(BB)) {
+        Errs << Prefix << "\tNot executable\n";
+      }
+      if (dfa::DumpVerbosity == dfa::Verbosity::Block) {
+        Errs << Prefix << "\t{";
+        for (const Instruction &Inst : BB) {
+          PrintCell(Inst);
+        }
+        Errs << "}\n";
+        continue;
+      }
+      for (const Instruction &Inst : BB) {
+        Inst.print(outs(), MST);
+        outs() << "\n";
+        Errs << Prefix << "\t{";
+        PrintCell(Inst);
+        Errs << "}\n";
+      }
+    }
   }
+  Errs << Prefix << "Converged after " << NumInstVisits
+       << " instruction visits, " << ExecutableBBs.size() << " out of "
+       << F.size() << " basic blocks executable\n";
+}
 
-  if(isa<CallInst>(&Inst)){
-    Tmp[DomainIdMap.find(var)->second] = dfa::ConstValue::getNac();
+PreservedAnalyses SCCPRewritePass::run(Function &F,
+                                       FunctionAnalysisManager &FAM) {
+  const SCCP &Solver = FAM.getResult<SCCP>(F).get();
+
+  // Collect all the changes before touching the IR, since the solver is keyed
+  // on the instructions and blocks that are about to be erased.
+  std::vector<std::pair<Instruction *, Constant *>> ConstInsts;
+  std::vector<std::pair<Instruction *, BasicBlock *>> FoldedTerms;
+  std::vector<BasicBlock *> DeadBBs;
+  for (BasicBlock &BB : F) {
+    if (!Solver.isExecutable(BB)) {
+      DeadBBs.push_back(&BB);
+      continue;
+    }
+    for (Instruction &Inst : BB) {
+      const ConstValue Val = Solver.getLatticeValue(&Inst);
+      if (Val.isConst() && !Inst.isTerminator() &&
+          Inst.getType()->isIntegerTy()) {
+        ConstInsts.emplace_back(
+            &Inst, ConstantInt::get(Inst.getContext(), Val.getConst()));
+      }
+    }
+    Instruction *const Term = BB.getTerminator();
+    if (!isa<BranchInst>(Term) && !isa<SwitchInst>(Term)) {
+      continue;
+    }
+    BasicBlock *Target = nullptr;
+    bool IsFoldable = false;
+    for (BasicBlock *const Succ : successors(&BB)) {
+      if (Succ == Target) {
+        continue;
+      }
+      if (!Solver.isEdgeExecutable(BB, *Succ)) {
+        IsFoldable = true;
+        continue;
+      }
+      if (Target != nullptr) {
+        IsFoldable = false;
+        break;
+      }
+      Target = Succ;
+    }
+    if (IsFoldable && Target != nullptr) {
+      FoldedTerms.emplace_back(Term, Target);
+    }
   }
 
-  for(std::size_t i = 0; i < Tmp.size(); ++i){
-    if(Tmp[i] != ODV[i]){
-      ODV = Tmp;
-      return true;
+  for (const auto &InstConst : ConstInsts) {
+    InstConst.first->replaceAllUsesWith(InstConst.second);
+    InstConst.first->eraseFromParent();
+  }
+  for (const auto &TermTarget : FoldedTerms) {
+    Instruction *const Term = TermTarget.first;
+    BasicBlock *const BB = Term->getParent();
+    // Keep exactly one edge to the target, and drop the incoming values of
+    // the other edges from the PHI nodes of the successors.
+    bool IsTargetKept = false;
+    for (BasicBlock *const Succ : successors(BB)) {
+      if (Succ == TermTarget.second && !IsTargetKept) {
+        IsTargetKept = true;
+        continue;
+      }
+      Succ->removePredecessor(BB);
+    }
+    BranchInst::Create(TermTarget.second, Term);
+    Term->eraseFromParent();
+  }
+  // A switch may still have some edges to blocks that are not executable.
+  // Those blocks are only emptied down to an `unreachable`, while the others
+  // are erased.
+  detachDeadBlocks(DeadBBs, nullptr);
+  size_t NumErasedBBs = 0;
+  for (BasicBlock *const BB : DeadBBs) {
+    if (pred_empty(BB)) {
+      BB->eraseFromParent();
+      ++NumErasedBBs;
     }
   }
 
-  return false;
+  LOG_ANALYSIS_INFO << "Folded " << ConstInsts.size()
+                    << " instructions to constants and " << FoldedTerms.size()
+                    << " branches, erased " << NumErasedBBs << " out of "
+                    << DeadBBs.size() << " unreachable basic blocks";
+
+  if (ConstInsts.empty() && FoldedTerms.empty() && DeadBBs.empty()) {
+    return PreservedAnalyses::all();
+  }
+  PreservedAnalyses PA;
+  if (FoldedTerms.empty() && DeadBBs.empty()) {
+    PA.preserveSet<CFGAnalyses>();
+  }
+  return PA;
 }
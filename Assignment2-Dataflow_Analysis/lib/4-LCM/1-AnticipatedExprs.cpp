@@ -1,3 +1,11 @@
 #include "LCM.h"
 
-/// @todo(CSCD70) Please complete this file.
+void AnticipatedExprs::transferFunc(const size_t InstNum, size_t,
+                                    DomainVal_t &Val) const {
+  // Val is the value after the instruction, and becomes the one before it.
+  Universe.applyKills(InstNum, Val);
+  const size_t ExprId = Universe.getExprId(InstNum);
+  if (ExprId != LCMUniverse::NoExprId) {
+    Val.set(ExprId);
+  }
+}
@@ -1,3 +1,10 @@
 #include "LCM.h"
 
-/// @todo(CSCD70) Please complete this file.
+void WBAvailExprs::transferFunc(const size_t InstNum, const size_t Pos,
+                                DomainVal_t &Val) const {
+  // The expressions that are anticipated right before the instruction are
+  // computed there at the latest, hence available after it unless it kills
+  // them.
+  Val.unionWith(AnticipatedVals[Pos]);
+  Universe.applyKills(InstNum, Val);
+}
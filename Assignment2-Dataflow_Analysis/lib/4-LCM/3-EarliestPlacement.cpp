@@ -1,3 +1,19 @@
 #include "LCM.h"
 
-/// @todo(CSCD70) Please complete this file.
+#include <utility>
+
+void EarliestPlacement::computeBB(const llvm::BasicBlock &BB,
+                                  BBVals_t &Placements) const {
+  Anticipated.walkBB(BB, AnticipatedVals);
+  WBAvail.walkBB(BB, Placements);
+  for (size_t Pos = 0; Pos < Placements.size(); ++Pos) {
+    std::swap(Placements[Pos], AnticipatedVals[Pos]);
+    Placements[Pos].reset(AnticipatedVals[Pos]);
+  }
+}
+
+void EarliestPlacement::getEntryPlacement(const llvm::BasicBlock &BB,
+                                          DomainVal_t &Val) const {
+  Val = Anticipated.getIn(BB);
+  Val.reset(WBAvail.getIn(BB));
+}
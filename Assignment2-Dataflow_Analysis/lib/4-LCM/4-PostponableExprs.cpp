@@ -1,3 +1,10 @@
 #include "LCM.h"
 
-/// @todo(CSCD70) Please complete this file.
+void PostponableExprs::transferFunc(const size_t InstNum, const size_t Pos,
+                                    DomainVal_t &Val) const {
+  Val.unionWith(EarliestVals[Pos]);
+  const size_t ExprId = Universe.getExprId(InstNum);
+  if (ExprId != LCMUniverse::NoExprId) {
+    Val.reset(ExprId);
+  }
+}
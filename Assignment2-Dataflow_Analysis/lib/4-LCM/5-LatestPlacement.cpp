@@ -1,3 +1,48 @@
 #include "LCM.h"
 
-/// @todo(CSCD70) Please complete this file.
+#include <llvm/IR/CFG.h>
+
+using namespace llvm;
+
+void LatestPlacement::computeBB(const BasicBlock &BB,
+                                BBVals_t &Placements) const {
+  // The candidates before an instruction are the expressions that are either
+  // placed earliest or postponable there.
+  Earliest.computeBB(BB, EarliestVals);
+  Postponable.walkBB(BB, Placements);
+  const size_t NumInsts = Placements.size() - 1;
+  for (size_t Pos = 0; Pos < NumInsts; ++Pos) {
+    Placements[Pos].unionWith(EarliestVals[Pos]);
+  }
+  // Those after the block are the ones before every successor.
+  DomainVal_t &Candidates = Placements[NumInsts];
+  bool IsFirst = true;
+  for (const BasicBlock *const Succ : successors(&BB)) {
+    Earliest.getEntryPlacement(*Succ, SuccCandidates);
+    SuccCandidates.unionWith(Postponable.getIn(*Succ));
+    if (IsFirst) {
+      std::swap(Candidates, SuccCandidates);
+      IsFirst = false;
+    } else {
+      Candidates.intersectWith(SuccCandidates);
+    }
+  }
+  if (IsFirst) {
+    Candidates = DomainVal_t(Universe.size(), true);
+  }
+
+  // The candidates that are not candidates after the instruction cannot be
+  // postponed any further. Those of them that the instruction uses have to
+  // be placed right before it.
+  const size_t FirstInst = Universe.getFirstInst(Universe.getBBId(BB));
+  for (size_t Pos = 0; Pos < NumInsts; ++Pos) {
+    const size_t ExprId = Universe.getExprId(FirstInst + Pos);
+    const bool IsUsed =
+        ExprId != LCMUniverse::NoExprId && Placements[Pos].test(ExprId);
+    Placements[Pos].reset(Placements[Pos + 1]);
+    if (IsUsed) {
+      Placements[Pos].set(ExprId);
+    }
+  }
+  Placements[NumInsts] = DomainVal_t(Universe.size());
+}
@@ -1,3 +1,11 @@
 #include "LCM.h"
 
-/// @todo(CSCD70) Please complete this file.
+void UsedExprs::transferFunc(const size_t InstNum, const size_t Pos,
+                             DomainVal_t &Val) const {
+  // Val is the value after the instruction, and becomes the one before it.
+  const size_t ExprId = Universe.getExprId(InstNum);
+  if (ExprId != LCMUniverse::NoExprId) {
+    Val.set(ExprId);
+  }
+  Val.reset(LatestVals[Pos]);
+}
@@ -0,0 +1,554 @@
+#include "LCM.h"
+
+#include <DFA/Flow/Framework.h>
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/SSAUpdater.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+using dfa::PackedBitVector;
+
+void LCMUniverse::build(const Function &F) {
+  Exprs.clear();
+  InstInfos.clear();
+  BBs.clear();
+  BBIds.clear();
+  BBFirstInsts.clear();
+  for (const BasicBlock *const BB :
+       ReversePostOrderTraversal<const Function *>(&F)) {
+    BBIds.try_emplace(BB, BBs.size());
+    BBs.push_back(BB);
+  }
+  for (const BasicBlock &BB : F) {
+    if (BBIds.try_emplace(&BB, BBs.size()).second) {
+      BBs.push_back(&BB);
+    }
+  }
+
+  // The expressions are numbered in the layout order, as the domains of the
+  // analyses of the framework are, and the instructions in the block order.
+  dfa::Expression::DomainIdMap_t ExprIds;
+  DenseMap<const Value *, SmallVector<unsigned, 2>> ContainingExprs;
+  auto GetExpr = [](const Instruction &Inst) -> const BinaryOperator * {
+    const auto *const BO = dyn_cast<BinaryOperator>(&Inst);
+    return BO != nullptr && isSafeToSpeculativelyExecute(BO) ? BO : nullptr;
+  };
+  for (const Instruction &Inst : instructions(&F)) {
+    const BinaryOperator *const BO = GetExpr(Inst);
+    if (BO == nullptr ||
+        !ExprIds.emplace(dfa::Expression(*BO), Exprs.size()).second) {
+      continue;
+    }
+    Exprs.emplace_back(*BO);
+    for (const Value *const Val : Exprs.back().getValues()) {
+      SmallVector<unsigned, 2> &ValExprs = ContainingExprs[Val];
+      if (ValExprs.empty() || ValExprs.back() != Exprs.size() - 1) {
+        ValExprs.push_back(Exprs.size() - 1);
+      }
+    }
+  }
+  for (const BasicBlock *const BB : BBs) {
+    BBFirstInsts.push_back(InstInfos.size());
+    for (const Instruction &Inst : *BB) {
+      InstInfos.emplace_back();
+      if (const BinaryOperator *const BO = GetExpr(Inst)) {
+        InstInfos.back().ExprId = ExprIds.at(dfa::Expression(*BO));
+      }
+      const auto Iter = ContainingExprs.find(&Inst);
+      if (Iter != ContainingExprs.end()) {
+        InstInfos.back().Kills = std::move(Iter->second);
+      }
+    }
+  }
+  BBFirstInsts.push_back(InstInfos.size());
+}
+
+void LCMUniverse::print(raw_ostream &Errs, ModuleSlotTracker &MST,
+                        const std::string &Prefix,
+                        const PackedBitVector &Val) const {
+  Errs << Prefix << "\t{";
+  for (size_t ExprId = Val.findNext(0); ExprId != Val.size();
+       ExprId = Val.findNext(ExprId + 1)) {
+    Exprs[ExprId].print(Errs, MST);
+    Errs << ", ";
+  }
+  Errs << "}\n";
+}
+
+void LCMStage::transferBB(const BasicBlock &BB, DomainVal_t &Val) const {
+  const unsigned BBId = Universe.getBBId(BB);
+  const size_t FirstInst = Universe.getFirstInst(BBId),
+               NumInsts = Universe.getNumInsts(BBId);
+  if (isForward()) {
+    for (size_t Pos = 0; Pos < NumInsts; ++Pos) {
+      transferFunc(FirstInst + Pos, Pos, Val);
+    }
+    return;
+  }
+  for (size_t Pos = NumInsts; Pos-- > 0;) {
+    transferFunc(FirstInst + Pos, Pos, Val);
+  }
+}
+
+void LCMStage::walkBB(const BasicBlock &BB, BBVals_t &Vals) const {
+  const unsigned BBId = Universe.getBBId(BB);
+  const size_t FirstInst = Universe.getFirstInst(BBId),
+               NumInsts = Universe.getNumInsts(BBId);
+  Vals.resize(NumInsts + 1);
+  prepareBB(BB);
+  if (isForward()) {
+    Vals[0] = Ins[BBId];
+    for (size_t Pos = 0; Pos < NumInsts; ++Pos) {
+      Vals[Pos + 1] = Vals[Pos];
+      transferFunc(FirstInst + Pos, Pos, Vals[Pos + 1]);
+    }
+    return;
+  }
+  Vals[NumInsts] = Outs[BBId];
+  for (size_t Pos = NumInsts; Pos-- > 0;) {
+    Vals[Pos] = Vals[Pos + 1];
+    transferFunc(FirstInst + Pos, Pos, Vals[Pos]);
+  }
+}
+
+void LCMStage::solve(const Function &) {
+  const std::vector<const BasicBlock *> &BBs = Universe.getBBs();
+  const size_t NumExprs = Universe.size();
+  const bool IsForward = isForward(), IsMeetUnion = isMeetUnion();
+  Ins.assign(BBs.size(), DomainVal_t(NumExprs, !IsMeetUnion));
+  Outs.assign(BBs.size(), DomainVal_t(NumExprs, !IsMeetUnion));
+  // Values at the block boundaries on the side that the solver meets over,
+  // and on the side that it computes.
+  std::vector<DomainVal_t> &MeetVals = IsForward ? Ins : Outs,
+                           &ExitVals = IsForward ? Outs : Ins;
+
+  // The transfer functions of a block compose into `OUT = (IN - KILL) U GEN`
+  // , which is summarized by applying them to the empty set (which yields
+  // GEN) and to the full set (which yields the complement of KILL). The
+  // summaries only live until the fixpoint is reached.
+  std::vector<DomainVal_t> Gens(BBs.size(), DomainVal_t(NumExprs)),
+      Preserved(BBs.size(), DomainVal_t(NumExprs, true));
+  for (size_t BBId = 0; BBId < BBs.size(); ++BBId) {
+    prepareBB(*BBs[BBId]);
+    transferBB(*BBs[BBId], Gens[BBId]);
+    transferBB(*BBs[BBId], Preserved[BBId]);
+  }
+
+  // Sweep over the blocks that are pending until none is left, in reverse
+  // post-order for the forward stages and in post-order for the backward
+  // ones.
+  std::vector<bool> Pending(BBs.size(), true);
+  std::vector<size_t> BBVisits(BBs.size(), 0);
+  size_t NumPending = BBs.size();
+  NumBBVisits = 0;
+  DomainVal_t Tmp;
+  while (NumPending != 0) {
+    for (size_t Idx = 0; Idx < BBs.size(); ++Idx) {
+      const size_t BBId = IsForward ? Idx : BBs.size() - 1 - Idx;
+      if (!Pending[BBId]) {
+        continue;
+      }
+      Pending[BBId] = false;
+      --NumPending;
+      ++NumBBVisits;
+      ++BBVisits[BBId];
+
+      const BasicBlock &BB = *BBs[BBId];
+      DomainVal_t &MeetVal = MeetVals[BBId];
+      bool IsFirst = true;
+      auto Meet = [&](const BasicBlock *const MeetBB) {
+        const DomainVal_t &Val = ExitVals[Universe.getBBId(*MeetBB)];
+        if (IsFirst) {
+          MeetVal = Val;
+          IsFirst = false;
+        } else if (IsMeetUnion) {
+          MeetVal.unionWith(Val);
+        } else {
+          MeetVal.intersectWith(Val);
+        }
+      };
+      if (IsForward) {
+        for_each(predecessors(&BB), Meet);
+      } else {
+        for_each(successors(&BB), Meet);
+      }
+      // Boundary condition, at the entry (exit) of the function.
+      if (IsFirst) {
+        MeetVal = DomainVal_t(NumExprs);
+      }
+      Tmp = MeetVal;
+      Tmp.intersectWith(Preserved[BBId]);
+      Tmp.unionWith(Gens[BBId]);
+      if (Tmp == ExitVals[BBId]) {
+        continue;
+      }
+      std::swap(Tmp, ExitVals[BBId]);
+      auto Enqueue = [&](const BasicBlock *const DepBB) {
+        const unsigned DepId = Universe.getBBId(*DepBB);
+        if (!Pending[DepId]) {
+          Pending[DepId] = true;
+          ++NumPending;
+        }
+      };
+      if (IsForward) {
+        for_each(successors(&BB), Enqueue);
+      } else {
+        for_each(predecessors(&BB), Enqueue);
+      }
+    }
+  }
+  MaxBBVisits = BBVisits.empty()
+                    ? 0
+                    : *std::max_element(BBVisits.begin(), BBVisits.end());
+}
+
+void LCMStage::print(const Function &F) const {
+  if (dfa::DumpVerbosity == dfa::Verbosity::None) {
+    return;
+  }
+  // errs() is unbuffered, hence write through a buffered stream on the same
+  // file descriptor instead.
+  errs().flush();
+  raw_fd_ostream Errs(STDERR_FILENO, /*shouldClose=*/false);
+  ModuleSlotTracker MST(F.getParent());
+  MST.incorporateFunction(F);
+  const std::string Prefix = "CHECK: [" + getName() + "] ";
+
+  // The values are listed in the order of the traversal, as the dump of
+  // the analyses of the framework does, i.e., the value after each
+  // instruction of a forward stage and the one before it of a backward one.
+  const bool IsForward = isForward(),
+             PrintInsts = dfa::DumpVerbosity == dfa::Verbosity::Full;
+  if (dfa::DumpVerbosity >= dfa::Verbosity::Block) {
+    BBVals_t Vals;
+    for (const BasicBlock &BB : F) {
+      if (IsForward) {
+        Errs << "\n";
+        Universe.print(Errs, MST, Prefix, getIn(BB));
+      }
+      if (PrintInsts) {
+        walkBB(BB, Vals);
+        size_t Pos = 0;
+        for (const Instruction &Inst : BB) {
+          Inst.print(outs(), MST);
+          outs() << "\n";
+          ++Pos;
+          Universe.print(Errs, MST, Prefix, Vals[IsForward ? Pos : Pos - 1]);
+        }
+      } else {
+        Universe.print(Errs, MST, Prefix, IsForward ? getOut(BB) : getIn(BB));
+      }
+      if (!IsForward) {
+        Errs << "\n";
+        Universe.print(Errs, MST, Prefix, getOut(BB));
+      }
+    }
+  }
+  Errs << Prefix << "Converged after " << NumBBVisits
+       << " basic block visits, at most " << MaxBBVisits
+       << " of one basic block\n";
+}
+
+void LCMPlacement::print(const Function &F) const {
+  if (dfa::DumpVerbosity == dfa::Verbosity::None) {
+    return;
+  }
+  errs().flush();
+  raw_fd_ostream Errs(STDERR_FILENO, /*shouldClose=*/false);
+  ModuleSlotTracker MST(F.getParent());
+  MST.incorporateFunction(F);
+  const std::string Prefix = "CHECK: [" + getName() + "] ";
+
+  BBVals_t Placements;
+  DomainVal_t BBPlacements;
+  size_t NumPlaced = 0, NumPlacedInsts = 0;
+  for (const BasicBlock &BB : F) {
+    computeBB(BB, Placements);
+    BBPlacements = DomainVal_t(Universe.size());
+    for (size_t Pos = 0; Pos + 1 < Placements.size(); ++Pos) {
+      BBPlacements.unionWith(Placements[Pos]);
+      const size_t Count = Placements[Pos].count();
+      NumPlaced += Count;
+      NumPlacedInsts += Count != 0;
+    }
+    if (dfa::DumpVerbosity < dfa::Verbosity::Block) {
+      continue;
+    }
+    Errs << "\n";
+    Universe.print(Errs, MST, Prefix, BBPlacements);
+    if (dfa::DumpVerbosity != dfa::Verbosity::Full) {
+      continue;
+    }
+    size_t Pos = 0;
+    for (const Instruction &Inst : BB) {
+      Inst.print(outs(), MST);
+      outs() << "\n";
+      Universe.print(Errs, MST, Prefix, Placements[Pos++]);
+    }
+  }
+  Errs << Prefix << "Placed " << NumPlaced << " computations before "
+       << NumPlacedInsts << " instructions\n";
+}
+
+namespace {
+
+/// @brief Split the edges into the blocks that have several predecessors, so
+///        that computations can be placed on them.
+/// @return The blocks that have been inserted on the edges.
+std::vector<BasicBlock *> splitJoinEdges(Function &F) {
+  std::vector<std::pair<BasicBlock *, BasicBlock *>> Edges;
+  for (BasicBlock &BB : F) {
+    SmallVector<BasicBlock *, 4> Preds;
+    SmallPtrSet<BasicBlock *, 4> VisitedPreds;
+    for (BasicBlock *const Pred : predecessors(&BB)) {
+      if (VisitedPreds.insert(Pred).second) {
+        Preds.push_back(Pred);
+      }
+    }
+    if (Preds.size() < 2) {
+      continue;
+    }
+    for (BasicBlock *const Pred : Preds) {
+      // The other terminators (e.g., `indirectbr` ) cannot be redirected,
+      // hence the placements stay at the entry of the join block.
+      const Instruction *const Term = Pred->getTerminator();
+      if (isa<BranchInst>(Term) || isa<SwitchInst>(Term)) {
+        Edges.emplace_back(Pred, &BB);
+      }
+    }
+  }
+  std::vector<BasicBlock *> SplitBBs;
+  for (const auto &Edge : Edges) {
+    if (BasicBlock *const SplitBB = SplitEdge(Edge.first, Edge.second)) {
+      SplitBBs.push_back(SplitBB);
+    }
+  }
+  return SplitBBs;
+}
+
+/// @brief Undo the split of an edge, either by merging the split block into
+///        its predecessor or, if nothing has been placed in it, by branching
+///        around it. The incoming blocks of the PHI nodes keep their order.
+bool unsplitEdge(BasicBlock &SplitBB) {
+  if (MergeBlockIntoPredecessor(&SplitBB)) {
+    return true;
+  }
+  BasicBlock *const Pred = SplitBB.getSinglePredecessor(),
+             *const Succ = SplitBB.getSingleSuccessor();
+  if (SplitBB.size() != 1 || Pred == nullptr || Succ == nullptr) {
+    return false;
+  }
+  Pred->getTerminator()->replaceSuccessorWith(&SplitBB, Succ);
+  for (PHINode &PHI : Succ->phis()) {
+    PHI.replaceIncomingBlockWith(&SplitBB, Pred);
+  }
+  SplitBB.eraseFromParent();
+  return true;
+}
+
+/// @brief Rewrite of the program point right before an instruction, in the
+///        order of the instructions.
+struct LCMAction {
+  size_t ExprId;
+  Instruction *Inst;
+  enum ActionKind {
+    Insert, ///< Compute the expression in a temporary before @c Inst .
+    Keep,   ///< Keep @c Inst , which computes the expression, as temporary.
+    Replace ///< Replace @c Inst by the temporary that reaches it.
+  } Kind;
+};
+
+} // anonymous namespace
+
+PreservedAnalyses LCMWrapperPass::run(Function &F,
+                                      FunctionAnalysisManager &) {
+  // Some EH pads (e.g., `catchswitch` ) do not have any insertion point.
+  for (const BasicBlock &BB : F) {
+    if (BB.isEHPad()) {
+      LOG_ANALYSIS_INFO << "@" << F.getName()
+                        << ": skipped, as it has exception handling pads";
+      return PreservedAnalyses::all();
+    }
+  }
+  const std::vector<BasicBlock *> SplitBBs = splitJoinEdges(F);
+
+  // The expression universe is built once, and every stage only keeps the
+  // values at the block boundaries over it.
+  LCMUniverse Universe;
+  Universe.build(F);
+  AnticipatedExprs Anticipated(Universe);
+  Anticipated.solve(F);
+  Anticipated.print(F);
+  WBAvailExprs WBAvail(Universe, Anticipated);
+  WBAvail.solve(F);
+  WBAvail.print(F);
+  EarliestPlacement Earliest(Universe, Anticipated, WBAvail);
+  Earliest.print(F);
+  PostponableExprs Postponable(Universe, Earliest);
+  Postponable.solve(F);
+  Postponable.print(F);
+  LatestPlacement Latest(Universe, Earliest, Postponable);
+  Latest.print(F);
+  UsedExprs Used(Universe, Latest);
+  Used.solve(F);
+  Used.print(F);
+
+  // Plan the rewrites before touching any instruction, since the universe
+  // numbers the instructions of the function that it has been built on. The
+  // computations in unreachable blocks are left untouched.
+  const size_t NumExprs = Universe.size();
+  std::vector<LCMAction> Actions;
+  std::vector<BinaryOperator *> Reprs(NumExprs, nullptr);
+  size_t NumComps = 0;
+  LCMStage::BBVals_t LatestVals, UsedVals;
+  PackedBitVector Inserted;
+  for (BasicBlock *const BB : ReversePostOrderTraversal<Function *>(&F)) {
+    Latest.computeBB(*BB, LatestVals);
+    Used.walkBB(*BB, UsedVals);
+    size_t InstNum = Universe.getFirstInst(Universe.getBBId(*BB)), Pos = 0;
+    for (Instruction &Inst : *BB) {
+      const size_t ExprId = Universe.getExprId(InstNum++);
+      const PackedBitVector &UsedAfter = UsedVals[Pos + 1],
+                            &LatestBefore = LatestVals[Pos];
+      ++Pos;
+      Inserted = UsedAfter;
+      Inserted.intersectWith(LatestBefore);
+      for (size_t InsertedId = Inserted.findNext(0);
+           InsertedId != Inserted.size();
+           InsertedId = Inserted.findNext(InsertedId + 1)) {
+        if (InsertedId != ExprId) {
+          Actions.push_back(
+              {.ExprId = InsertedId, .Inst = &Inst, .Kind = LCMAction::Insert});
+        }
+      }
+      if (ExprId == LCMUniverse::NoExprId) {
+        continue;
+      }
+      ++NumComps;
+      if (Reprs[ExprId] == nullptr) {
+        Reprs[ExprId] = cast<BinaryOperator>(&Inst);
+      }
+      // A computation that is placed latest and not used afterwards stays as
+      // it is, and all the other ones read the temporary.
+      if (Inserted.test(ExprId)) {
+        Actions.push_back(
+            {.ExprId = ExprId, .Inst = &Inst, .Kind = LCMAction::Keep});
+      } else if (!LatestBefore.test(ExprId) || UsedAfter.test(ExprId)) {
+        Actions.push_back(
+            {.ExprId = ExprId, .Inst = &Inst, .Kind = LCMAction::Replace});
+      }
+    }
+  }
+
+  // Materialize the temporaries. Those that are read in the block that
+  // defines them are forwarded directly, and the others once the value at
+  // the exit of every block is known.
+  SmallVector<PHINode *, 8> InsertedPHIs;
+  std::vector<std::unique_ptr<SSAUpdater>> Updaters(NumExprs);
+  std::vector<SmallVector<Instruction *, 2>> Temps(NumExprs);
+  std::vector<SmallVector<BinaryOperator *, 4>> Replaced(NumExprs);
+  DenseMap<Instruction *, Value *> Replacements;
+  DenseMap<size_t, Instruction *> BBTemps;
+  size_t NumInserted = 0;
+  auto FlushBBTemps = [&](BasicBlock *const BB) {
+    for (const auto &ExprTemp : BBTemps) {
+      std::unique_ptr<SSAUpdater> &Updater = Updaters[ExprTemp.first];
+      if (Updater == nullptr) {
+        Updater = std::make_unique<SSAUpdater>(&InsertedPHIs);
+        Updater->Initialize(ExprTemp.second->getType(),
+                            Reprs[ExprTemp.first]->getName());
+      }
+      Updater->AddAvailableValue(BB, ExprTemp.second);
+    }
+    BBTemps.clear();
+  };
+  BasicBlock *CurBB = nullptr;
+  for (const LCMAction &Action : Actions) {
+    if (Action.Inst->getParent() != CurBB) {
+      FlushBBTemps(CurBB);
+      CurBB = Action.Inst->getParent();
+    }
+    switch (Action.Kind) {
+    case LCMAction::Insert: {
+      BinaryOperator *const Repr = Reprs[Action.ExprId];
+      Instruction *const Temp = Repr->clone();
+      if (Repr->hasName()) {
+        Temp->setName(Repr->getName() + ".lcm");
+      }
+      Temp->insertBefore(isa<PHINode>(Action.Inst)
+                             ? &*CurBB->getFirstInsertionPt()
+                             : Action.Inst);
+      Temps[Action.ExprId].push_back(Temp);
+      BBTemps[Action.ExprId] = Temp;
+      ++NumInserted;
+      break;
+    }
+    case LCMAction::Keep:
+      Temps[Action.ExprId].push_back(Action.Inst);
+      BBTemps[Action.ExprId] = Action.Inst;
+      break;
+    case LCMAction::Replace:
+      Replaced[Action.ExprId].push_back(cast<BinaryOperator>(Action.Inst));
+      Replacements[Action.Inst] = BBTemps.lookup(Action.ExprId);
+      break;
+    }
+  }
+  FlushBBTemps(CurBB);
+
+  size_t NumReplaced = 0;
+  for (size_t ExprId = 0; ExprId < NumExprs; ++ExprId) {
+    // The temporaries must not be more poisonous than the computations that
+    // they replace.
+    for (Instruction *const Temp : Temps[ExprId]) {
+      for (BinaryOperator *const Comp : Replaced[ExprId]) {
+        if (Comp->getOpcode() == Temp->getOpcode()) {
+          Temp->andIRFlags(Comp);
+        }
+      }
+    }
+    for (BinaryOperator *const Comp : Replaced[ExprId]) {
+      Value *Replacement = Replacements.lookup(Comp);
+      if (Replacement == nullptr) {
+        CHECK(Updaters[ExprId] != nullptr)
+            << "Computation " << *Comp << " is replaced by a temporary that "
+            << "is never computed";
+        Replacement = Updaters[ExprId]->GetValueInMiddleOfBlock(
+            Comp->getParent());
+      }
+      Comp->replaceAllUsesWith(Replacement);
+      Comp->eraseFromParent();
+      ++NumReplaced;
+    }
+  }
+
+  size_t NumSplitEdges = 0;
+  for (BasicBlock *const SplitBB : SplitBBs) {
+    if (!unsplitEdge(*SplitBB)) {
+      ++NumSplitEdges;
+    }
+  }
+
+  LOG_ANALYSIS_INFO << "@" << F.getName() << ": inserted " << NumInserted
+                    << " and replaced " << NumReplaced << " out of "
+                    << NumComps << " computations, inserted "
+                    << InsertedPHIs.size() << " PHI nodes, split "
+                    << NumSplitEdges << " out of " << SplitBBs.size()
+                    << " edges";
+
+  if (NumInserted == 0 && NumReplaced == 0 && NumSplitEdges == 0) {
+    return PreservedAnalyses::all();
+  }
+  return PreservedAnalyses::none();
+}
@@ -1,15 +1,303 @@
 #pragma once // NOLINT(llvm-header-guard)
 
+#include <DFA/Domain/Expression.h>
+#include <DFA/PackedBitVector.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/ModuleSlotTracker.h>
 #include <llvm/IR/PassManager.h>
 
-class LCMWrapperPass : public llvm::PassInfoMixin<LCMWrapperPass> {
+#include <string>
+#include <vector>
+
+/// @brief Expressions that Lazy Code Motion places, i.e., the binary
+///        operators that can be computed wherever their operands are defined.
+///        Divisions and remainders by a value that might be zero are left
+///        out, since computing them earlier could trap before the side
+///        effects of the instructions in between.
+///
+///        The universe is built once per function and shared by all the
+///        stages, which only keep bit-vectors over it. Instructions are
+///        numbered block by block, in the order of @c getBBs , so that a
+///        stage walking a block reads their expressions and kill sets from
+///        the number of the first instruction of the block on.
+class LCMUniverse {
 public:
-  llvm::PreservedAnalyses run(llvm::Function &F,
-                              llvm::FunctionAnalysisManager &FAM) {
+  static constexpr size_t NoExprId = static_cast<size_t>(-1);
+
+private:
+  dfa::Expression::DomainVector_t Exprs;
+  struct InstInfo {
+    /// @brief Expression computed by the instruction, if any.
+    size_t ExprId = NoExprId;
+    /// @brief Expressions that use the value of the instruction.
+    llvm::SmallVector<unsigned, 2> Kills;
+  };
+  std::vector<InstInfo> InstInfos;
+  /// @brief Blocks in reverse post-order, followed by the unreachable ones,
+  ///        and their positions.
+  std::vector<const llvm::BasicBlock *> BBs;
+  llvm::DenseMap<const llvm::BasicBlock *, unsigned> BBIds;
+  /// @brief Number of the first instruction of every block, indexed by
+  ///        @c BBIds , followed by the number of instructions.
+  std::vector<size_t> BBFirstInsts;
+
+public:
+  void build(const llvm::Function &F);
+
+  size_t size() const { return Exprs.size(); }
+  const std::vector<const llvm::BasicBlock *> &getBBs() const { return BBs; }
+  unsigned getBBId(const llvm::BasicBlock &BB) const {
+    return BBIds.lookup(&BB);
+  }
+  size_t getFirstInst(const unsigned BBId) const {
+    return BBFirstInsts[BBId];
+  }
+  size_t getNumInsts(const unsigned BBId) const {
+    return BBFirstInsts[BBId + 1] - BBFirstInsts[BBId];
+  }
+  size_t getExprId(const size_t InstNum) const {
+    return InstInfos[InstNum].ExprId;
+  }
+  /// @brief Clear the expressions that instruction @p InstNum redefines an
+  ///        operand of from @p Val .
+  void applyKills(const size_t InstNum, dfa::PackedBitVector &Val) const {
+    for (const unsigned ExprId : InstInfos[InstNum].Kills) {
+      Val.reset(ExprId);
+    }
+  }
+  /// @brief Print @p Val as one line of the dump, after @p Prefix .
+  void print(llvm::raw_ostream &Errs, llvm::ModuleSlotTracker &MST,
+             const std::string &Prefix, const dfa::PackedBitVector &Val) const;
+};
+
+/// @brief Dataflow stage of Lazy Code Motion, solved at the granularity of
+///        blocks over the shared universe.
+///
+///        Only the values at the block boundaries are kept. The values before
+///        the instructions of a block are recomputed when the block is walked,
+///        and the transfer functions of a stage read those of the previous
+///        stages by walking the same block from their boundary values. The
+///        walks go through scratch buffers that are reused from one block to
+///        the next.
+class LCMStage {
+public:
+  using DomainVal_t = dfa::PackedBitVector;
+  /// @brief Values before every instruction of a block, in program order,
+  ///        followed by the value after the block.
+  using BBVals_t = std::vector<DomainVal_t>;
+
+protected:
+  const LCMUniverse &Universe;
+  /// @brief Values before and after every block, in program order, indexed
+  ///        by the block ids of the universe.
+  std::vector<DomainVal_t> Ins, Outs;
+  size_t NumBBVisits = 0, MaxBBVisits = 0;
+
+  explicit LCMStage(const LCMUniverse &Universe) : Universe(Universe) {}
+  virtual ~LCMStage() = default;
+  virtual std::string getName() const = 0;
+  virtual bool isForward() const = 0;
+  /// @brief Whether the meet operator is the union, rather than the
+  ///        intersection.
+  virtual bool isMeetUnion() const { return false; }
+  /// @brief Walk the previous stages over @p BB , for @c transferFunc to read
+  ///        their values.
+  virtual void prepareBB(const llvm::BasicBlock &) const {}
+  /// @brief Apply the transfer function of the instruction at @p Pos in its
+  ///        block, numbered @p InstNum in the universe, to @p Val in place.
+  virtual void transferFunc(size_t InstNum, size_t Pos,
+                            DomainVal_t &Val) const = 0;
+
+  /// @brief Apply the transfer functions of @p BB to @p Val in place, in the
+  ///        direction of the stage.
+  void transferBB(const llvm::BasicBlock &BB, DomainVal_t &Val) const;
+
+public:
+  void solve(const llvm::Function &F);
+  /// @brief Compute the values before every instruction of @p BB .
+  void walkBB(const llvm::BasicBlock &BB, BBVals_t &Vals) const;
+  const DomainVal_t &getIn(const llvm::BasicBlock &BB) const {
+    return Ins[Universe.getBBId(BB)];
+  }
+  const DomainVal_t &getOut(const llvm::BasicBlock &BB) const {
+    return Outs[Universe.getBBId(BB)];
+  }
+  /// @brief Dump the values of the last solved function, with as much detail
+  ///        as @c dfa::DumpVerbosity requests.
+  void print(const llvm::Function &F) const;
+};
+
+/// @brief Expressions that are computed on every path from a program point
+///        before any of their operands is redefined, i.e., that could be
+///        computed at that point without adding a computation to any path.
+class AnticipatedExprs final : public LCMStage {
+private:
+  std::string getName() const final { return "AnticipatedExprs"; }
+  bool isForward() const final { return false; }
+  void transferFunc(size_t InstNum, size_t Pos,
+                    DomainVal_t &Val) const final;
+
+public:
+  explicit AnticipatedExprs(const LCMUniverse &Universe)
+      : LCMStage(Universe) {}
+};
+
+/// @brief Expressions that "will be available" at a program point if every
+///        one of them is computed as early as it is anticipated, i.e., that
+///        are anticipated at some point on every path from the entry and not
+///        killed since.
+class WBAvailExprs final : public LCMStage {
+private:
+  const AnticipatedExprs &Anticipated;
+  mutable BBVals_t AnticipatedVals;
+
+  std::string getName() const final { return "WBAvailExprs"; }
+  bool isForward() const final { return true; }
+  void prepareBB(const llvm::BasicBlock &BB) const final {
+    Anticipated.walkBB(BB, AnticipatedVals);
+  }
+  void transferFunc(size_t InstNum, size_t Pos,
+                    DomainVal_t &Val) const final;
+
+public:
+  WBAvailExprs(const LCMUniverse &Universe,
+               const AnticipatedExprs &Anticipated)
+      : LCMStage(Universe), Anticipated(Anticipated) {}
+};
+
+/// @brief Expressions placed right before every instruction, which are
+///        derived from the values of the previous stages block by block.
+class LCMPlacement {
+public:
+  using DomainVal_t = LCMStage::DomainVal_t;
+  using BBVals_t = LCMStage::BBVals_t;
+
+protected:
+  const LCMUniverse &Universe;
+
+  explicit LCMPlacement(const LCMUniverse &Universe) : Universe(Universe) {}
+  virtual ~LCMPlacement() = default;
+  virtual std::string getName() const = 0;
+
+public:
+  /// @brief Compute the expressions placed before every instruction of
+  ///        @p BB , in program order.
+  virtual void computeBB(const llvm::BasicBlock &BB,
+                         BBVals_t &Placements) const = 0;
+  /// @brief Dump the placements. The blocks list the union of the placements
+  ///        within them, and the instructions their own placements at full
+  ///        verbosity.
+  void print(const llvm::Function &F) const;
+};
+
+/// @brief Earliest placement of the expressions, i.e., the points where they
+///        are anticipated but would not be available yet.
+class EarliestPlacement final : public LCMPlacement {
+private:
+  const AnticipatedExprs &Anticipated;
+  const WBAvailExprs &WBAvail;
+  mutable BBVals_t AnticipatedVals;
 
-    /// @todo(CSCD70) Get the result from the main body.
+  std::string getName() const final { return "EarliestPlacement"; }
 
-    return llvm::PreservedAnalyses::all();
+public:
+  EarliestPlacement(const LCMUniverse &Universe,
+                    const AnticipatedExprs &Anticipated,
+                    const WBAvailExprs &WBAvail)
+      : LCMPlacement(Universe), Anticipated(Anticipated), WBAvail(WBAvail) {}
+  void computeBB(const llvm::BasicBlock &BB,
+                 BBVals_t &Placements) const final;
+  /// @brief Get the placement before the first instruction of @p BB , from
+  ///        the block-level values only.
+  void getEntryPlacement(const llvm::BasicBlock &BB, DomainVal_t &Val) const;
+};
+
+/// @brief Expressions whose earliest placement can be postponed to a program
+///        point, i.e., that are placed earliest on every path from the entry
+///        and have not been used since.
+class PostponableExprs final : public LCMStage {
+private:
+  const EarliestPlacement &Earliest;
+  mutable BBVals_t EarliestVals;
+
+  std::string getName() const final { return "PostponableExprs"; }
+  bool isForward() const final { return true; }
+  void prepareBB(const llvm::BasicBlock &BB) const final {
+    Earliest.computeBB(BB, EarliestVals);
   }
+  void transferFunc(size_t InstNum, size_t Pos,
+                    DomainVal_t &Val) const final;
+
+public:
+  PostponableExprs(const LCMUniverse &Universe,
+                   const EarliestPlacement &Earliest)
+      : LCMStage(Universe), Earliest(Earliest) {}
+};
+
+/// @brief Latest placement of the expressions, i.e., the points up to which
+///        they can be postponed and beyond which they cannot, either because
+///        the instruction uses them or because one of its successors is not a
+///        placement candidate.
+class LatestPlacement final : public LCMPlacement {
+private:
+  const EarliestPlacement &Earliest;
+  const PostponableExprs &Postponable;
+  mutable BBVals_t EarliestVals;
+  mutable DomainVal_t SuccCandidates;
+
+  std::string getName() const final { return "LatestPlacement"; }
+
+public:
+  LatestPlacement(const LCMUniverse &Universe,
+                  const EarliestPlacement &Earliest,
+                  const PostponableExprs &Postponable)
+      : LCMPlacement(Universe), Earliest(Earliest), Postponable(Postponable) {
+  }
+  void computeBB(const llvm::BasicBlock &BB,
+                 BBVals_t &Placements) const final;
+};
+
+/// @brief Expressions that are used later on some path from a program point
+///        without being placed in between, i.e., whose latest placement has to
+///        be kept in a temporary.
+class UsedExprs final : public LCMStage {
+private:
+  const LatestPlacement &Latest;
+  mutable BBVals_t LatestVals;
+
+  std::string getName() const final { return "UsedExprs"; }
+  bool isForward() const final { return false; }
+  bool isMeetUnion() const final { return true; }
+  void prepareBB(const llvm::BasicBlock &BB) const final {
+    Latest.computeBB(BB, LatestVals);
+  }
+  void transferFunc(size_t InstNum, size_t Pos,
+                    DomainVal_t &Val) const final;
+
+public:
+  UsedExprs(const LCMUniverse &Universe, const LatestPlacement &Latest)
+      : LCMStage(Universe), Latest(Latest) {}
+};
+
+/// @brief Lazy Code Motion (Knoop, Rüthing and Steffen).
+///
+///        The edges into join blocks are split first, so that computations
+///        can be placed on them. Every candidate expression is then computed
+///        in a temporary at its latest placement, provided that the temporary
+///        is used afterwards, and the computations that the temporaries make
+///        redundant are replaced by them. This eliminates the partial
+///        redundancies without adding a computation to any path, and without
+///        computing any expression earlier than needed, which keeps the live
+///        ranges of the temporaries short. Split edges that end up empty are
+///        merged back.
+class LCMWrapperPass : public llvm::PassInfoMixin<LCMWrapperPass> {
+private:
+  std::string getName() const { return "LCM"; }
+
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM);
 };
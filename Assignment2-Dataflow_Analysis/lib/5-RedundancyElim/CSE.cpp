@@ -0,0 +1,144 @@
+#include "RedundancyElim.h"
+
+#include "../DFA.h"
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Transforms/Utils/SSAUpdater.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+
+PreservedAnalyses CSEPass::run(Function &F, FunctionAnalysisManager &FAM) {
+  const auto Begin = std::chrono::steady_clock::now();
+  AvailExprs::Result &AE = FAM.getResult<AvailExprs>(F);
+
+  // Computations of every expression in reverse post-order, and those of them
+  // that are redundant. Unreachable blocks are left untouched.
+  DenseMap<size_t, SmallVector<BinaryOperator *, 4>> Computations;
+  std::vector<BinaryOperator *> Redundant;
+  size_t NumExprs = 0;
+  for (BasicBlock *const BB : ReversePostOrderTraversal<Function *>(&F)) {
+    for (Instruction &Inst : *BB) {
+      auto *const BO = dyn_cast<BinaryOperator>(&Inst);
+      const size_t ExprId =
+          BO == nullptr ? AvailExprs::NoDomainId : AE.getDomainId(BO);
+      if (ExprId == AvailExprs::NoDomainId) {
+        continue;
+      }
+      ++NumExprs;
+      Computations[ExprId].push_back(BO);
+      if (AE.getIn(*BO)[ExprId]) {
+        Redundant.push_back(BO);
+      }
+    }
+  }
+
+  // Find the value that replaces each redundant computation. The
+  // replacements themselves may be redundant, hence nothing is rewritten
+  // before all of them are known.
+  SmallVector<PHINode *, 8> InsertedPHIs;
+  DenseMap<size_t, std::unique_ptr<SSAUpdater>> Updaters;
+  DenseMap<BinaryOperator *, Value *> Replacements;
+  for (BinaryOperator *const BO : Redundant) {
+    const size_t ExprId = AE.getDomainId(BO);
+    const SmallVector<BinaryOperator *, 4> &ExprComps = Computations[ExprId];
+
+    // The latest computation that precedes it in the same block, if any.
+    BinaryOperator *LocalComp = nullptr;
+    for (BinaryOperator *const Comp : ExprComps) {
+      if (Comp != BO && Comp->getParent() == BO->getParent() &&
+          Comp->comesBefore(BO)) {
+        LocalComp = Comp;
+      }
+    }
+    if (LocalComp != nullptr) {
+      Replacements.try_emplace(BO, LocalComp);
+      continue;
+    }
+    std::unique_ptr<SSAUpdater> &Updater = Updaters[ExprId];
+    if (Updater == nullptr) {
+      Updater = std::make_unique<SSAUpdater>(&InsertedPHIs);
+      Updater->Initialize(BO->getType(), BO->getName());
+      // The computations are in reverse post-order, so the last one of each
+      // block is the value that is available at its exit.
+      for (BinaryOperator *const Comp : ExprComps) {
+        Updater->AddAvailableValue(Comp->getParent(), Comp);
+      }
+    }
+    Replacements.try_emplace(BO,
+                             Updater->GetValueInMiddleOfBlock(BO->getParent()));
+  }
+
+  for (BinaryOperator *const BO : Redundant) {
+    Value *Replacement = Replacements.lookup(BO);
+    while (Replacements.count(dyn_cast<BinaryOperator>(Replacement))) {
+      Replacement = Replacements.lookup(cast<BinaryOperator>(Replacement));
+    }
+    // The computations that are kept must not be more poisonous than the
+    // ones that they replace.
+    for (BinaryOperator *const Comp : Computations[AE.getDomainId(BO)]) {
+      if (Replacements.count(Comp) == 0 &&
+          Comp->getOpcode() == BO->getOpcode()) {
+        Comp->andIRFlags(BO);
+      }
+    }
+    BO->replaceAllUsesWith(Replacement);
+  }
+  for (BinaryOperator *const BO : Redundant) {
+    BO->eraseFromParent();
+  }
+
+  // Computations that have been replaced by a PHI node of their own block
+  // leave that PHI node referring to itself, e.g., `%p = phi [%v, ...], [%p,
+  // ...]` in a loop header. Fold such trivial PHI nodes and drop the unused
+  // ones until nothing changes.
+  SmallPtrSet<PHINode *, 8> LivePHIs(InsertedPHIs.begin(), InsertedPHIs.end());
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (PHINode *const PHI : InsertedPHIs) {
+      if (LivePHIs.count(PHI) == 0) {
+        continue;
+      }
+      Value *Common = nullptr;
+      bool IsTrivial = true;
+      for (Value *const Incoming : PHI->incoming_values()) {
+        if (Incoming == PHI || Incoming == Common) {
+          continue;
+        }
+        if (Common != nullptr) {
+          IsTrivial = false;
+          break;
+        }
+        Common = Incoming;
+      }
+      if (IsTrivial && Common != nullptr) {
+        PHI->replaceAllUsesWith(Common);
+      } else if (!PHI->use_empty()) {
+        continue;
+      }
+      LivePHIs.erase(PHI);
+      PHI->eraseFromParent();
+      Changed = true;
+    }
+  }
+
+  const std::chrono::duration<double, std::milli> Elapsed =
+      std::chrono::steady_clock::now() - Begin;
+  LOG_ANALYSIS_INFO << "Eliminated " << Redundant.size() << " out of "
+                    << NumExprs << " binary expressions, inserted "
+                    << LivePHIs.size() << " PHI nodes in "
+                    << format("%.3f", Elapsed.count()) << " ms";
+
+  if (Redundant.empty()) {
+    return PreservedAnalyses::all();
+  }
+  PreservedAnalyses PA;
+  PA.preserveSet<CFGAnalyses>();
+  return PA;
+}
@@ -0,0 +1,37 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/PassManager.h>
+
+#include <string>
+
+/// @brief Dominator-based redundancy elimination keyed on value numbers.
+///
+///        Walks the dominator tree while keeping the leader (i.e., the first
+///        dominating definition) of every value number in scope. Instructions
+///        whose value number already has a leader, or stands for a constant,
+///        are replaced and erased.
+class VNElimPass : public llvm::PassInfoMixin<VNElimPass> {
+private:
+  std::string getName() const { return "VNElim"; }
+
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM);
+};
+
+/// @brief Common subexpression elimination driven by available expressions.
+///
+///        Every binary operator whose expression is available right before it
+///        is replaced by the value computed on the paths that reach it, i.e.,
+///        either by an earlier computation in the same block or by the value
+///        that reaches the entry of the block, with PHI nodes inserted where
+///        different computations merge.
+class CSEPass : public llvm::PassInfoMixin<CSEPass> {
+private:
+  std::string getName() const { return "CSE"; }
+
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM);
+};
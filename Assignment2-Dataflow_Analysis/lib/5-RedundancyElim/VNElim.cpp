@@ -0,0 +1,113 @@
+#include "RedundancyElim.h"
+
+#include <DFA/Domain/ValueNumbering.h>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Dominators.h>
+
+#include <vector>
+
+using namespace llvm;
+using dfa::ValueNumbering;
+
+PreservedAnalyses VNElimPass::run(Function &F, FunctionAnalysisManager &FAM) {
+  const DominatorTree &DT = FAM.getResult<DominatorTreeAnalysis>(F);
+  ValueNumbering VN;
+  VN.numberFunction(F);
+
+  // Leader of every value number in the current scope. The value numbers that
+  // get a leader in a block are logged so that they can be dropped when
+  // leaving the subtree of that block.
+  DenseMap<ValueNumbering::VN_t, Value *> Leaders;
+  std::vector<ValueNumbering::VN_t> UndoLog;
+  std::vector<Instruction *> DeadInsts;
+  size_t NumFolded = 0;
+
+  for (Argument &Arg : F.args()) {
+    Leaders.try_emplace(VN.getValueNumber(&Arg), &Arg);
+  }
+
+  auto ProcessBB = [&](BasicBlock &BB) {
+    for (Instruction &Inst : BB) {
+      if (Inst.getType()->isVoidTy()) {
+        continue;
+      }
+      const ValueNumbering::VN_t InstVN = VN.getValueNumber(&Inst);
+      // Only binary operators and PHI nodes may share their value number.
+      const bool IsRedundant = isa<BinaryOperator>(Inst) || isa<PHINode>(Inst);
+
+      Value *Replacement = nullptr;
+      if (IsRedundant && VN.isConst(InstVN)) {
+        Replacement = ConstantInt::get(Inst.getType(), VN.getConst(InstVN));
+        ++NumFolded;
+      } else if (IsRedundant) {
+        const auto Iter = Leaders.find(InstVN);
+        if (Iter != Leaders.end()) {
+          Replacement = Iter->second;
+        }
+      }
+      if (Replacement == nullptr) {
+        if (Leaders.try_emplace(InstVN, &Inst).second) {
+          UndoLog.push_back(InstVN);
+        }
+        continue;
+      }
+      // The leader may carry poison-generating flags that the replaced
+      // instruction does not have.
+      auto *const LeaderBO = dyn_cast<BinaryOperator>(Replacement);
+      if (LeaderBO != nullptr && isa<BinaryOperator>(Inst) &&
+          LeaderBO->getOpcode() == Inst.getOpcode()) {
+        LeaderBO->andIRFlags(&Inst);
+      }
+      Inst.replaceAllUsesWith(Replacement);
+      DeadInsts.push_back(&Inst);
+    }
+  };
+
+  struct ScopeEntry {
+    const DomTreeNode *Node;
+    DomTreeNode::const_iterator ChildIter;
+    size_t UndoLogSize;
+  };
+  std::vector<ScopeEntry> Scopes;
+  const DomTreeNode *const Root = DT.getRootNode();
+  ProcessBB(*Root->getBlock());
+  Scopes.push_back(
+      {.Node = Root, .ChildIter = Root->begin(), .UndoLogSize = 0});
+  while (!Scopes.empty()) {
+    if (Scopes.back().ChildIter != Scopes.back().Node->end()) {
+      const DomTreeNode *const Child = *Scopes.back().ChildIter++;
+      const size_t UndoLogSize = UndoLog.size();
+      ProcessBB(*Child->getBlock());
+      Scopes.push_back({.Node = Child,
+                        .ChildIter = Child->begin(),
+                        .UndoLogSize = UndoLogSize});
+      continue;
+    }
+    while (UndoLog.size() > Scopes.back().UndoLogSize) {
+      Leaders.erase(UndoLog.back());
+      UndoLog.pop_back();
+    }
+    Scopes.pop_back();
+  }
+
+  // PHI nodes may refer to instructions that come after them, hence drop all
+  // the references before erasing anything.
+  for (Instruction *const Inst : DeadInsts) {
+    Inst->dropAllReferences();
+  }
+  for (Instruction *const Inst : DeadInsts) {
+    Inst->eraseFromParent();
+  }
+  LOG_ANALYSIS_INFO << "Eliminated " << DeadInsts.size()
+                    << " redundant instructions (" << NumFolded
+                    << " folded to constants) out of "
+                    << VN.getNumValueNumbers() << " value numbers";
+
+  if (DeadInsts.empty()) {
+    return PreservedAnalyses::all();
+  }
+  PreservedAnalyses PA;
+  PA.preserveSet<CFGAnalyses>();
+  return PA;
+}
@@ -1,5 +1,7 @@
 #include "DFA.h"
 
+#include <DFA/ModuleDriver.h>
+
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Passes/PassPlugin.h>
 
@@ -16,7 +18,10 @@ extern "C" PassPluginLibraryInfo llvmGetPassPluginInfo() {
                 [](FunctionAnalysisManager &FAM) {
                   FAM.registerPass([&]() { return AvailExprs(); });
                   FAM.registerPass([&]() { return Liveness(); });
+                  FAM.registerPass([&]() { return BlockLiveness(); });
+                  FAM.registerPass([&]() { return SSALiveness(); });
                   FAM.registerPass([&]() {return SCCP(); });
+                  FAM.registerPass([&]() { return RangeProp(); });
                   /// @todo(CSCD70) Please complete the registration of other
                   ///               passes.
                 });
@@ -31,14 +36,81 @@ extern "C" PassPluginLibraryInfo llvmGetPassPluginInfo() {
                     FPM.addPass(LivenessWrapperPass());
                     return true;
                   }
+                  if (Name == "block-liveness") {
+                    FPM.addPass(BlockLivenessWrapperPass());
+                    return true;
+                  }
+                  if (Name == "ssa-liveness") {
+                    FPM.addPass(SSALivenessWrapperPass());
+                    return true;
+                  }
+                  if (Name == "reg-pressure") {
+                    FPM.addPass(RegPressurePass());
+                    return true;
+                  }
                   if (Name == "const-prop") {
                     FPM.addPass(SCCPWrapperPass());
                     return true;
                   }
+                  if (Name == "const-prop-rewrite") {
+                    FPM.addPass(SCCPRewritePass());
+                    return true;
+                  }
+                  if (Name == "range-prop") {
+                    FPM.addPass(RangePropWrapperPass());
+                    return true;
+                  }
+                  if (Name == "range-prop-rewrite") {
+                    FPM.addPass(RangePropRewritePass());
+                    return true;
+                  }
                   if (Name == "lcm") {
                     FPM.addPass(LCMWrapperPass());
                     return true;
                   }
+                  if (Name == "cse") {
+                    FPM.addPass(CSEPass());
+                    return true;
+                  }
+                  if (Name == "vn-elim") {
+                    FPM.addPass(VNElimPass());
+                    return true;
+                  }
+                  return false;
+                });
+            // Module-level counterparts of the analyses above, which solve
+            // all the functions of the module in parallel.
+            PB.registerPipelineParsingCallback(
+                [](StringRef Name, ModulePassManager &MPM,
+                   ArrayRef<PassBuilder::PipelineElement>) -> bool {
+                  if (Name == "parallel-avail-expr") {
+                    MPM.addPass(dfa::ModuleDriverPass<AvailExprs>());
+                    return true;
+                  }
+                  if (Name == "parallel-liveness") {
+                    MPM.addPass(dfa::ModuleDriverPass<Liveness>());
+                    return true;
+                  }
+                  if (Name == "parallel-block-liveness") {
+                    MPM.addPass(dfa::ModuleDriverPass<BlockLiveness>());
+                    return true;
+                  }
+                  if (Name == "parallel-ssa-liveness") {
+                    MPM.addPass(dfa::ModuleDriverPass<SSALiveness>());
+                    return true;
+                  }
+                  if (Name == "liveness-check") {
+                    MPM.addPass(LivenessCheckPass());
+                    return true;
+                  }
+                  if (Name == "parallel-const-prop") {
+                    MPM.addPass(dfa::ModuleDriverPass<SCCP>());
+                    return true;
+                  }
+                  if (Name == "parallel-range-prop") {
+                    MPM.addPass(dfa::ModuleDriverPass<RangeProp>());
+                    return true;
+                  }
                   return false;
                 });
           } // RegisterPassBuilderCallbacks
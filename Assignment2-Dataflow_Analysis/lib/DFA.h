@@ -1,33 +1,48 @@
 #pragma once // NOLINT(llvm-header-guard)
 
 #include "4-LCM/LCM.h"
+#include "5-RedundancyElim/RedundancyElim.h"
 
 #include <DFA/Domain/Expression.h>
+#include <DFA/Domain/ValueNumbering.h>
 #include <DFA/Domain/Variable.h>
 #include <DFA/Flow/ForwardAnalysis.h>
 #include <DFA/Flow/BackwardAnalysis.h>
+#include <DFA/Flow/GenKillAnalysis.h>
 #include <DFA/MeetOp.h>
+#include <DFA/PackedBitVector.h>
 
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/PassManager.h>
 
-class AvailExprs final : public dfa::ForwardAnalysis<dfa::Expression, dfa::Bool,
-                                                     dfa::Intersect<dfa::Bool>>,
-                         public llvm::AnalysisInfoMixin<AvailExprs> {
+class AvailExprs final
+    : public dfa::GenKillAnalysis<dfa::ForwardAnalysis<
+          dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>>>,
+      public llvm::AnalysisInfoMixin<AvailExprs> {
 private:
-  using ForwardAnalysis_t = dfa::ForwardAnalysis<dfa::Expression, dfa::Bool,
-                                                 dfa::Intersect<dfa::Bool>>;
+  using ForwardAnalysis_t = dfa::GenKillAnalysis<dfa::ForwardAnalysis<
+      dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>>>;
 
   friend llvm::AnalysisInfoMixin<AvailExprs>;
   static llvm::AnalysisKey Key;
 
+  /// @brief Value numbers of the function, so that the expressions that are
+  ///        known to compute the same value share one domain element.
+  dfa::ValueNumbering VN;
+  llvm::DenseMap<dfa::ValueNumbering::VN_t, size_t> VNDomainIds;
+
   std::string getName() const final { return "AvailExprs"; }
   bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
                     DomainVal_t &) final;
+  void initializeDomain(const llvm::Function &F) final;
   void initializeDomainFromInst(const llvm::Instruction &Inst) final;
 
 public:
-  using Result = typename ForwardAnalysis_t::AnalysisResult_t;
-  using ForwardAnalysis_t::run;
+  using Result = dfa::AnalysisResult<AvailExprs>;
+  Result run(llvm::Function &F, llvm::FunctionAnalysisManager &) {
+    return Result::compute(F);
+  }
 };
 
 class AvailExprsWrapperPass
@@ -42,11 +57,12 @@ public:
 
 /// @todo(CSCD70) Please complete the main body of the following passes, similar
 ///               to the Available Expressions pass above.
-class Liveness final : public dfa::BackwardAnalysis<dfa::Variable, dfa::Bool, 
-                                                    dfa::Union<dfa::Bool>>,
+class Liveness final : public dfa::GenKillAnalysis<dfa::BackwardAnalysis<
+                           dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>>,
                        public llvm::AnalysisInfoMixin<Liveness>{
   private:
-    using BackwardAnalysis_t = dfa::BackwardAnalysis<dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>;
+    using BackwardAnalysis_t = dfa::GenKillAnalysis<dfa::BackwardAnalysis<
+        dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>>;
 
     friend llvm::AnalysisInfoMixin<Liveness>;
     static llvm::AnalysisKey Key;
@@ -55,9 +71,18 @@ class Liveness final : public dfa::BackwardAnalysis<dfa::Variable, dfa::Bool,
     bool transferFunc(const llvm::Instruction &, const DomainVal_t &, DomainVal_t &) final;
     void initializeDomainFromInst(const llvm::Instruction &Inst) final;
 
+    /// @brief Incoming values of the successor PHIs that flow from other
+    ///        predecessors, collected once per basic block.
+    llvm::SmallVector<size_t, 4> PHIKills;
+    void initializeInstDomainIds(const llvm::Instruction &,
+                                 const ContainingIds_t &,
+                                 InstDomainIds &) final;
+
   public:
-    using Result = typename BackwardAnalysis_t::AnalysisResult_t;
-    using BackwardAnalysis_t::run;
+    using Result = dfa::AnalysisResult<Liveness>;
+    Result run(llvm::Function &F, llvm::FunctionAnalysisManager &) {
+      return Result::compute(F);
+    }
 };
 
 class LivenessWrapperPass : public llvm::PassInfoMixin<LivenessWrapperPass> {
@@ -71,28 +96,248 @@ public:
   }
 };
 
+/// @brief Live-in and live-out sets of every basic block, as computed by the
+///        liveness engines below, together with the queries and the dump
+///        that they share.
+///
+///        PHI nodes follow the SSA semantics: an incoming value is live out of
+///        its incoming block only, and a PHI node is defined at the entry of
+///        its block, hence it is not live in there.
+class LiveSets {
+protected:
+  static constexpr size_t NoVarId = static_cast<size_t>(-1);
+
+  /// @brief Variables (i.e., arguments and instructions that are used) and
+  ///        their bit positions.
+  llvm::DenseMap<const llvm::Value *, unsigned> VarIds;
+  std::vector<const llvm::Value *> Vars;
+  /// @brief Blocks in post-order, followed by the unreachable ones, and
+  ///        their positions.
+  std::vector<const llvm::BasicBlock *> BBs;
+  llvm::DenseMap<const llvm::BasicBlock *, unsigned> BBIds;
+  /// @brief Live sets of every block, indexed by @c BBIds .
+  std::vector<dfa::PackedBitVector> LiveIns, LiveOuts;
+  size_t NumBBVisits = 0;
+
+  virtual ~LiveSets() = default;
+  virtual std::string getName() const = 0;
+  /// @brief Number the variables and the blocks of @p F , and clear all the
+  ///        live sets.
+  void initialize(const llvm::Function &F);
+  /// @brief Get the bit position of @p Val , or @c NoVarId if it is not a
+  ///        variable.
+  size_t getVarId(const llvm::Value *const Val) const {
+    const auto Iter = VarIds.find(Val);
+    return Iter == VarIds.end() ? NoVarId : Iter->second;
+  }
+
+public:
+  /// @brief Dump the live-in and live-out sets of the last solved function,
+  ///        with as much detail as @c dfa::DumpVerbosity requests.
+  void print(const llvm::Function &F) const;
+
+  const std::vector<const llvm::Value *> &getVars() const { return Vars; }
+  /// @brief Get the live-in set of @p BB , whose bits follow @c getVars .
+  const dfa::PackedBitVector &getLiveIn(const llvm::BasicBlock &BB) const {
+    return LiveIns[BBIds.lookup(&BB)];
+  }
+  const dfa::PackedBitVector &getLiveOut(const llvm::BasicBlock &BB) const {
+    return LiveOuts[BBIds.lookup(&BB)];
+  }
+  bool isLiveIn(const llvm::Value *const Val,
+                const llvm::BasicBlock &BB) const {
+    const size_t VarId = getVarId(Val);
+    return VarId != NoVarId && LiveIns[BBIds.lookup(&BB)].test(VarId);
+  }
+  bool isLiveOut(const llvm::Value *const Val,
+                 const llvm::BasicBlock &BB) const {
+    const size_t VarId = getVarId(Val);
+    return VarId != NoVarId && LiveOuts[BBIds.lookup(&BB)].test(VarId);
+  }
+  /// @brief Check whether @p Val is live right before @p Inst , by scanning
+  ///        the rest of the block of @p Inst only.
+  bool isLiveAt(const llvm::Value *const Val,
+                const llvm::Instruction &Inst) const;
+  size_t getNumBBVisits() const { return NumBBVisits; }
+};
+
+/// @brief Liveness at the granularity of basic blocks.
+///
+///        Unlike @c Liveness , which keeps a domain value per instruction and
+///        re-walks the PHI nodes of the successors for every instruction, the
+///        uses, definitions and incoming values of the PHI nodes on every
+///        outgoing edge are collected once per block. The solver then only
+///        iterates over the live-in and live-out bit-vectors of the blocks.
+class BlockLiveness final : public LiveSets,
+                            public llvm::AnalysisInfoMixin<BlockLiveness> {
+private:
+  friend llvm::AnalysisInfoMixin<BlockLiveness>;
+  static llvm::AnalysisKey Key;
+
+  /// @brief Per-block summaries, indexed by @c BBIds .
+  struct BBInfo {
+    /// @brief Variables that are used before being defined in the block,
+    ///        apart from the incoming values of its PHI nodes.
+    dfa::PackedBitVector UEUses;
+    dfa::PackedBitVector Defs;
+    /// @brief Incoming values of the PHI nodes of the successors on the
+    ///        outgoing edges of the block.
+    llvm::SmallVector<unsigned, 4> PHIUses;
+  };
+  std::vector<BBInfo> BBInfos;
+
+  std::string getName() const final { return "BlockLiveness"; }
+  void summarizeBB(const llvm::BasicBlock &BB, BBInfo &Info) const;
+
+public:
+  void solve(const llvm::Function &F);
+
+  using Result = dfa::AnalysisResult<BlockLiveness>;
+  Result run(llvm::Function &F, llvm::FunctionAnalysisManager &) {
+    return Result::compute(F);
+  }
+};
+
+class BlockLivenessWrapperPass
+    : public llvm::PassInfoMixin<BlockLivenessWrapperPass> {
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM) {
+    FAM.getResult<BlockLiveness>(F);
+    return llvm::PreservedAnalyses::all();
+  }
+};
+
+/// @brief Liveness computed one variable at a time, by walking its uses up
+///        the CFG until its definition is reached (i.e., the path
+///        exploration of Appel and Boissinot et al.). Since the IR is in SSA
+///        form, every variable has a single definition and no fixpoint
+///        iteration is needed.
+class SSALiveness final : public LiveSets,
+                          public llvm::AnalysisInfoMixin<SSALiveness> {
+private:
+  friend llvm::AnalysisInfoMixin<SSALiveness>;
+  static llvm::AnalysisKey Key;
+
+  std::string getName() const final { return "SSALiveness"; }
+  /// @brief Mark the blocks in which the variable @p VarId is live.
+  void exploreUses(const size_t VarId,
+                   std::vector<const llvm::BasicBlock *> &Worklist);
+
+public:
+  void solve(const llvm::Function &F);
+
+  using Result = dfa::AnalysisResult<SSALiveness>;
+  Result run(llvm::Function &F, llvm::FunctionAnalysisManager &) {
+    return Result::compute(F);
+  }
+};
+
+class SSALivenessWrapperPass
+    : public llvm::PassInfoMixin<SSALivenessWrapperPass> {
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM) {
+    FAM.getResult<SSALiveness>(F);
+    return llvm::PreservedAnalyses::all();
+  }
+};
+
+/// @brief Cross-check @c BlockLiveness against @c SSALiveness on every
+///        function of the module and compare their running times. Every
+///        disagreement on a live-in or live-out set is reported.
+class LivenessCheckPass : public llvm::PassInfoMixin<LivenessCheckPass> {
+private:
+  std::string getName() const { return "LivenessCheck"; }
+
+public:
+  llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &);
+};
 
-class SCCP final : public dfa::ForwardAnalysis<dfa::Variable, dfa::ConstValue,
-                                                     dfa::ConstIntersect<dfa::ConstValue>>,
-                         public llvm::AnalysisInfoMixin<SCCP> {
+/// @brief Register pressure estimated at the IR level, without running the
+///        backend.
+///
+///        The instructions of the reachable blocks are numbered in reverse
+///        post-order, and every variable gets a live interval (i.e., the
+///        segments of instruction slots at which it is live) from the live
+///        sets of @c BlockLiveness . The pressure at an instruction is the
+///        number of intervals that cover its slot, and its maximum and
+///        average are reported for the function, every loop and, from the
+///        block verbosity on, every block.
+class RegPressurePass : public llvm::PassInfoMixin<RegPressurePass> {
 private:
-  using ForwardAnalysis_t = dfa::ForwardAnalysis<dfa::Variable, dfa::ConstValue,
-                                                 dfa::ConstIntersect<dfa::ConstValue>>;
+  std::string getName() const { return "RegPressure"; }
 
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM);
+};
+
+/// @brief Sparse conditional constant propagation (Wegman & Zadeck).
+///
+///        Every SSA value has a single lattice cell, and the solver alternates
+///        between a worklist of CFG edges that have become executable and a
+///        worklist of SSA values whose cell has been lowered. Instructions are
+///        only evaluated once their block is executable, and PHI nodes only
+///        meet the incoming values of executable edges, hence constants that
+///        flow through branches with constant conditions are found as well.
+class SCCP final : public llvm::AnalysisInfoMixin<SCCP> {
+private:
   friend llvm::AnalysisInfoMixin<SCCP>;
   static llvm::AnalysisKey Key;
 
-  std::string getName() const final { return "SCCP"; }
-  bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
-                    DomainVal_t &) final;
-  void initializeDomainFromInst(const llvm::Instruction &Inst) final;
-  void handleBO(const llvm::Instruction &, const DomainVal_t &, dfa::ConstValue &);
+  using CFGEdge_t =
+      std::pair<const llvm::BasicBlock *, const llvm::BasicBlock *>;
+
+  dfa::ConstIntersect<dfa::ConstValue> MeetOp;
+  /// @brief Lattice cell of every instruction that has been evaluated. The
+  ///        instructions without a cell are still undefined.
+  llvm::DenseMap<const llvm::Value *, dfa::ConstValue> Cells;
+  llvm::DenseSet<const llvm::BasicBlock *> ExecutableBBs;
+  /// @brief Executable CFG edges. The entry block is reached through the
+  ///        edge from @c nullptr .
+  llvm::DenseSet<CFGEdge_t> ExecutableEdges;
+  std::vector<CFGEdge_t> CFGWorklist;
+  std::vector<const llvm::Instruction *> SSAWorklist;
+  size_t NumInstVisits = 0;
+
+  std::string getName() const { return "SCCP"; }
+  void markEdgeExecutable(const llvm::BasicBlock *const From,
+                          const llvm::BasicBlock *const To);
+  /// @brief Lower the cell of @p Inst to its meet with @p Val , queueing the
+  ///        users of @p Inst if the cell has changed.
+  void updateCell(const llvm::Instruction &Inst, const dfa::ConstValue &Val);
+  void visitInst(const llvm::Instruction &Inst);
+  void visitPHI(const llvm::PHINode &PHI);
+  void visitTerminator(const llvm::Instruction &Term);
+  dfa::ConstValue foldBinaryOp(const llvm::BinaryOperator &BO) const;
+  dfa::ConstValue foldCast(const llvm::CastInst &Cast) const;
+  dfa::ConstValue foldICmp(const llvm::ICmpInst &ICmp) const;
+  dfa::ConstValue foldSelect(const llvm::SelectInst &Select) const;
 
-  void handleCMP(const llvm::Instruction &, const DomainVal_t &, dfa::ConstValue &);
-  void handlePHI(const llvm::Instruction &, const DomainVal_t &, dfa::ConstValue &);
 public:
-  using Result = typename ForwardAnalysis_t::AnalysisResult_t;
-  using ForwardAnalysis_t::run;
+  void solve(const llvm::Function &F);
+  /// @brief Dump the lattice cells of the last solved function, with as much
+  ///        detail as @c dfa::DumpVerbosity requests.
+  void print(const llvm::Function &F) const;
+
+  /// @brief Get the lattice value of @p Val . Integer constants are constant,
+  ///        instructions that have never been evaluated are undefined, and
+  ///        any other value (e.g., an argument) is not a constant.
+  dfa::ConstValue getLatticeValue(const llvm::Value *const Val) const;
+  bool isExecutable(const llvm::BasicBlock &BB) const {
+    return ExecutableBBs.count(&BB) != 0;
+  }
+  bool isEdgeExecutable(const llvm::BasicBlock &From,
+                        const llvm::BasicBlock &To) const {
+    return ExecutableEdges.count({&From, &To}) != 0;
+  }
+  size_t getNumInstVisits() const { return NumInstVisits; }
+
+  using Result = dfa::AnalysisResult<SCCP>;
+  Result run(llvm::Function &F, llvm::FunctionAnalysisManager &) {
+    return Result::compute(F);
+  }
 };
 
 class SCCPWrapperPass
@@ -105,4 +350,84 @@ public:
   }
 };
 
+/// @brief Rewrite the function with the result of @c SCCP : the instructions
+///        that are proven constant are replaced by their constant, branches
+///        with only one executable successor become unconditional, and the
+///        blocks that are never executable are erased.
+class SCCPRewritePass : public llvm::PassInfoMixin<SCCPRewritePass> {
+private:
+  std::string getName() const { return "SCCPRewrite"; }
+
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM);
+};
+
+/// @brief Range propagation, i.e., the integer range of every variable at
+///        every program point. Branches on integer comparisons refine the
+///        ranges of the compared values in the successors that have no other
+///        predecessor, e.g., `i` lies in `[0, n)` within the body of a loop
+///        guarded by `i < n`.
+class RangeProp final
+    : public dfa::ForwardAnalysis<dfa::Variable, dfa::RangeValue,
+                                  dfa::RangeUnion<dfa::RangeValue>>,
+      public llvm::AnalysisInfoMixin<RangeProp> {
+private:
+  using ForwardAnalysis_t =
+      dfa::ForwardAnalysis<dfa::Variable, dfa::RangeValue,
+                           dfa::RangeUnion<dfa::RangeValue>>;
+
+  friend llvm::AnalysisInfoMixin<RangeProp>;
+  static llvm::AnalysisKey Key;
+
+  std::string getName() const final { return "RangeProp"; }
+  bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                    DomainVal_t &) final;
+  void initializeDomainFromInst(const llvm::Instruction &Inst) final;
+
+  /// @brief Get the range of the operand @p Op , whose domain id is
+  ///        @p DomainId , in @p DV .
+  dfa::RangeValue getOperandRange(const llvm::Value *const Op,
+                                  const size_t DomainId,
+                                  const DomainVal_t &DV) const;
+  /// @brief Intersect the ranges in @p DV with the condition of the branch
+  ///        that leads to @p BB , if @p BB has a single predecessor.
+  void refineWithBranchCond(const llvm::BasicBlock &BB, DomainVal_t &DV) const;
+
+public:
+  using Result = dfa::AnalysisResult<RangeProp>;
+  Result run(llvm::Function &F, llvm::FunctionAnalysisManager &) {
+    return Result::compute(F);
+  }
+
+  /// @brief Range of every integer instruction right after its definition.
+  ///        The instructions that are never reached are left out.
+  using RangeTable_t =
+      llvm::DenseMap<const llvm::Value *, llvm::ConstantRange>;
+  static RangeTable_t computeRangeTable(const llvm::Function &F,
+                                        Result &Ranges);
+};
+
+class RangePropWrapperPass
+    : public llvm::PassInfoMixin<RangePropWrapperPass> {
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM) {
+    FAM.getResult<RangeProp>(F);
+    return llvm::PreservedAnalyses::all();
+  }
+};
+
+/// @brief Fold the conditional branches whose condition is known from
+///        @c RangeProp , and erase the blocks that become unreachable.
+class RangePropRewritePass
+    : public llvm::PassInfoMixin<RangePropRewritePass> {
+private:
+  std::string getName() const { return "RangePropRewrite"; }
+
+public:
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &FAM);
+};
+
 
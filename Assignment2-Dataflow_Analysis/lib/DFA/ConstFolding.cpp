@@ -0,0 +1,75 @@
+#include <DFA/ConstFolding.h>
+
+#include <llvm/IR/Instruction.h>
+
+using namespace llvm;
+
+bool dfa::foldBinaryOp(const unsigned Opcode, const APInt &LHS,
+                       const APInt &RHS, APInt &Res) {
+  const unsigned BitWidth = LHS.getBitWidth();
+  switch (Opcode) {
+  case Instruction::Add:
+    Res = LHS + RHS;
+    return true;
+  case Instruction::Sub:
+    Res = LHS - RHS;
+    return true;
+  case Instruction::Mul:
+    Res = LHS * RHS;
+    return true;
+  case Instruction::And:
+    Res = LHS & RHS;
+    return true;
+  case Instruction::Or:
+    Res = LHS | RHS;
+    return true;
+  case Instruction::Xor:
+    Res = LHS ^ RHS;
+    return true;
+  case Instruction::Shl:
+  case Instruction::LShr:
+  case Instruction::AShr:
+    // Shifting by at least the bit width yields poison.
+    if (RHS.uge(BitWidth)) {
+      return false;
+    }
+    Res = Opcode == Instruction::Shl
+              ? LHS.shl(RHS)
+              : (Opcode == Instruction::LShr ? LHS.lshr(RHS) : LHS.ashr(RHS));
+    return true;
+  case Instruction::UDiv:
+  case Instruction::URem:
+    if (RHS.isZero()) {
+      return false;
+    }
+    Res = Opcode == Instruction::UDiv ? LHS.udiv(RHS) : LHS.urem(RHS);
+    return true;
+  case Instruction::SDiv:
+  case Instruction::SRem:
+    // Division by zero and signed overflow are undefined behavior.
+    if (RHS.isZero() || (LHS.isMinSignedValue() && RHS.isAllOnes())) {
+      return false;
+    }
+    Res = Opcode == Instruction::SDiv ? LHS.sdiv(RHS) : LHS.srem(RHS);
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool dfa::foldIntCast(const unsigned Opcode, const APInt &Val,
+                      const unsigned DestBitWidth, APInt &Res) {
+  switch (Opcode) {
+  case Instruction::Trunc:
+    Res = Val.trunc(DestBitWidth);
+    return true;
+  case Instruction::ZExt:
+    Res = Val.zext(DestBitWidth);
+    return true;
+  case Instruction::SExt:
+    Res = Val.sext(DestBitWidth);
+    return true;
+  default:
+    return false;
+  }
+}
@@ -12,6 +12,14 @@ raw_ostream &operator<<(raw_ostream &Outs, const Expression &Expr) {
   return Outs;
 }
 
+void Expression::print(raw_ostream &Outs, ModuleSlotTracker &MST) const {
+  Outs << "[" << Instruction::getOpcodeName(Opcode) << " ";
+  LHS->printAsOperand(Outs, false, MST);
+  Outs << ", ";
+  RHS->printAsOperand(Outs, false, MST);
+  Outs << "]";
+}
+
 void Expression::Initializer::visitBinaryOperator(BinaryOperator &BO) {
 
   /// @todo(CSCD70) Please complete this method.
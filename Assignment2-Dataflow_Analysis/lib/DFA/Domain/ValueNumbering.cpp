@@ -0,0 +1,185 @@
+#include <DFA/ConstFolding.h>
+#include <DFA/Domain/ValueNumbering.h>
+
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+
+#include <utility>
+
+using namespace llvm;
+using dfa::ValueNumbering;
+
+namespace {
+
+uint64_t getMask(const unsigned BitWidth) {
+  return BitWidth == 64 ? ~uint64_t(0) : (uint64_t(1) << BitWidth) - 1;
+}
+
+} // anonymous namespace
+
+ValueNumbering::VN_t ValueNumbering::getConstNumber(const Type *const Ty,
+                                                    const uint64_t Val) {
+  const auto Iter = ConstNumbers.find({Ty, Val});
+  if (Iter != ConstNumbers.end()) {
+    return Iter->second;
+  }
+  const VN_t VN = createValueNumber();
+  ConstInfos[VN] = {.IsConst = true, .Ty = Ty, .Val = Val};
+  ConstNumbers.try_emplace({Ty, Val}, VN);
+  return VN;
+}
+
+ValueNumbering::VN_t
+ValueNumbering::numberBinaryOperator(const BinaryOperator &BO) {
+  const unsigned Opcode = BO.getOpcode();
+  VN_t LHS = getValueNumber(BO.getOperand(0)),
+       RHS = getValueNumber(BO.getOperand(1));
+
+  const Type *const Ty = BO.getType();
+  if (Ty->isIntegerTy() && Ty->getIntegerBitWidth() <= 64) {
+    const unsigned BitWidth = Ty->getIntegerBitWidth();
+    const uint64_t AllOnes = getMask(BitWidth);
+    if (isConst(LHS) && isConst(RHS)) {
+      APInt Res;
+      if (dfa::foldBinaryOp(Opcode, APInt(BitWidth, getConst(LHS)),
+                            APInt(BitWidth, getConst(RHS)), Res)) {
+        return getConstNumber(Ty, Res.getZExtValue());
+      }
+    }
+    // Identity operands, e.g., `x + 0`, `x * 1` and `x & -1`.
+    if (isConst(RHS)) {
+      const uint64_t Val = getConst(RHS);
+      switch (Opcode) {
+      case Instruction::Add:
+      case Instruction::Sub:
+      case Instruction::Or:
+      case Instruction::Xor:
+      case Instruction::Shl:
+      case Instruction::LShr:
+      case Instruction::AShr:
+        if (Val == 0) {
+          return LHS;
+        }
+        break;
+      case Instruction::Mul:
+      case Instruction::UDiv:
+      case Instruction::SDiv:
+        if (Val == 1) {
+          return LHS;
+        }
+        break;
+      case Instruction::And:
+        if (Val == AllOnes) {
+          return LHS;
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    if (isConst(LHS)) {
+      const uint64_t Val = getConst(LHS);
+      if ((Val == 0 && (Opcode == Instruction::Add ||
+                        Opcode == Instruction::Or ||
+                        Opcode == Instruction::Xor)) ||
+          (Val == 1 && Opcode == Instruction::Mul) ||
+          (Val == AllOnes && Opcode == Instruction::And)) {
+        return RHS;
+      }
+    }
+    if (LHS == RHS) {
+      if (Opcode == Instruction::Sub || Opcode == Instruction::Xor) {
+        return getConstNumber(Ty, 0);
+      }
+      if (Opcode == Instruction::And || Opcode == Instruction::Or) {
+        return LHS;
+      }
+    }
+  }
+
+  if (Instruction::isCommutative(Opcode) && RHS < LHS) {
+    std::swap(LHS, RHS);
+  }
+  const ExprKey Key = {.Opcode = Opcode, .LHS = LHS, .RHS = RHS};
+  const auto Iter = ExprNumbers.find(Key);
+  if (Iter != ExprNumbers.end()) {
+    return Iter->second;
+  }
+  const VN_t VN = createValueNumber();
+  ExprNumbers.emplace(Key, VN);
+  return VN;
+}
+
+ValueNumbering::VN_t ValueNumbering::numberPHINode(const PHINode &PHI) {
+  // A PHI node whose incoming values are all equal is equal to them. Only the
+  // incoming values that have been numbered already are looked at, so that
+  // cycles through other PHI nodes do not have to be resolved.
+  bool HasCommonVN = false;
+  VN_t CommonVN = 0;
+  for (const Value *const Incoming : PHI.incoming_values()) {
+    if (Incoming == &PHI) {
+      continue;
+    }
+    if (!isa<Constant>(Incoming) && ValueNumbers.count(Incoming) == 0) {
+      return createValueNumber();
+    }
+    const VN_t VN = getValueNumber(Incoming);
+    if (HasCommonVN && VN != CommonVN) {
+      return createValueNumber();
+    }
+    HasCommonVN = true;
+    CommonVN = VN;
+  }
+  return HasCommonVN ? CommonVN : createValueNumber();
+}
+
+ValueNumbering::VN_t ValueNumbering::getValueNumber(const Value *const Val) {
+  const auto Iter = ValueNumbers.find(Val);
+  if (Iter != ValueNumbers.end()) {
+    return Iter->second;
+  }
+  VN_t VN;
+  const auto *const CI = dyn_cast<ConstantInt>(Val);
+  if (CI != nullptr && CI->getBitWidth() <= 64) {
+    VN = getConstNumber(CI->getType(), CI->getZExtValue());
+  } else if (const auto *const BO = dyn_cast<BinaryOperator>(Val)) {
+    VN = numberBinaryOperator(*BO);
+  } else if (const auto *const PHI = dyn_cast<PHINode>(Val)) {
+    VN = numberPHINode(*PHI);
+  } else {
+    VN = createValueNumber();
+  }
+  // Numbering the operands may have grown the map, so insert afresh.
+  ValueNumbers[Val] = VN;
+  return VN;
+}
+
+void ValueNumbering::numberFunction(const Function &F) {
+  for (const Argument &Arg : F.args()) {
+    getValueNumber(&Arg);
+  }
+  for (const BasicBlock *const BB :
+       ReversePostOrderTraversal<const Function *>(&F)) {
+    for (const Instruction &Inst : *BB) {
+      getValueNumber(&Inst);
+    }
+  }
+  // The instructions of the blocks that are unreachable from the entry get
+  // fresh numbers without looking at their operands, which may be defined in
+  // terms of themselves there, e.g., `%y = add i32 %y, 1`.
+  for (const Instruction &Inst : instructions(&F)) {
+    if (ValueNumbers.count(&Inst) == 0) {
+      ValueNumbers.try_emplace(&Inst, createValueNumber());
+    }
+  }
+}
+
+void ValueNumbering::clear() {
+  ValueNumbers.clear();
+  ExprNumbers.clear();
+  ConstNumbers.clear();
+  ConstInfos.clear();
+}
@@ -9,6 +9,11 @@ raw_ostream &operator<<(raw_ostream &Outs, const Variable &Var) {
   return Outs;
 }
 
+void Variable::print(raw_ostream &Outs, ModuleSlotTracker &MST) const {
+  CHECK(Var != nullptr);
+  Var->printAsOperand(Outs, true, MST);
+}
+
 void Variable::Initializer::visitInstruction(Instruction &I) {
 
   /// @todo(CSCD70) Please complete this method.
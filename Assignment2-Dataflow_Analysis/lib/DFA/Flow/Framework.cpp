@@ -0,0 +1,47 @@
+#include <DFA/Flow/Framework.h>
+#include <DFA/Flow/GenKillAnalysis.h>
+
+using namespace llvm;
+
+cl::opt<dfa::SolverKind> dfa::Solver(
+    "dfa-solver", cl::desc("Fixpoint solver used by the dataflow framework"),
+    cl::values(clEnumValN(dfa::SolverKind::Sweep, "sweep",
+                          "Re-traverse the whole CFG until convergence"),
+               clEnumValN(dfa::SolverKind::Worklist, "worklist",
+                          "Only revisit blocks whose inputs have changed")),
+    cl::init(dfa::SolverKind::Worklist));
+
+cl::opt<unsigned> dfa::InstValCacheSize(
+    "dfa-inst-cache-blocks",
+    cl::desc("Number of basic blocks whose per-instruction domain values are "
+             "kept after being recomputed"),
+    cl::init(8));
+
+cl::opt<dfa::Verbosity> dfa::DumpVerbosity(
+    "dfa-verbosity", cl::desc("Amount of analysis results that are printed"),
+    cl::values(clEnumValN(dfa::Verbosity::None, "none", "Print nothing"),
+               clEnumValN(dfa::Verbosity::Summary, "summary",
+                          "Only print the number of visits to convergence"),
+               clEnumValN(dfa::Verbosity::Block, "block",
+                          "Print the values at the basic block boundaries"),
+               clEnumValN(dfa::Verbosity::Full, "full",
+                          "Print the values after every instruction")),
+    cl::init(dfa::Verbosity::Full));
+
+cl::opt<bool> dfa::UseBBSummaries(
+    "dfa-bb-summaries",
+    cl::desc("Summarize the basic blocks of gen/kill analyses so that the "
+             "fixpoint iteration does not visit individual instructions"),
+    cl::init(true));
+
+cl::opt<unsigned> dfa::WideningDelay(
+    "dfa-widening-delay",
+    cl::desc("Number of visits of a loop header that only apply the meet "
+             "operator before the values at its entry are widened"),
+    cl::init(2));
+
+cl::opt<unsigned> dfa::NarrowingPasses(
+    "dfa-narrowing-passes",
+    cl::desc("Maximum number of sweeps over the CFG that narrow the values "
+             "after widening"),
+    cl::init(2));
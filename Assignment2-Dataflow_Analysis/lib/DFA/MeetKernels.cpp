@@ -0,0 +1,230 @@
+#include <DFA/MeetKernels.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DFA_MEET_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace dfa {
+namespace kernel {
+namespace {
+
+bool andScalar(Word_t *const Dst, const Word_t *const Src,
+               const std::size_t NumWords) {
+  Word_t Diff = 0;
+  for (std::size_t Idx = 0; Idx < NumWords; ++Idx) {
+    const Word_t NewWord = Dst[Idx] & Src[Idx];
+    Diff |= NewWord ^ Dst[Idx];
+    Dst[Idx] = NewWord;
+  }
+  return Diff != 0;
+}
+
+bool orScalar(Word_t *const Dst, const Word_t *const Src,
+              const std::size_t NumWords) {
+  Word_t Diff = 0;
+  for (std::size_t Idx = 0; Idx < NumWords; ++Idx) {
+    const Word_t NewWord = Dst[Idx] | Src[Idx];
+    Diff |= NewWord ^ Dst[Idx];
+    Dst[Idx] = NewWord;
+  }
+  return Diff != 0;
+}
+
+bool andNotScalar(Word_t *const Dst, const Word_t *const Src,
+                  const std::size_t NumWords) {
+  Word_t Diff = 0;
+  for (std::size_t Idx = 0; Idx < NumWords; ++Idx) {
+    const Word_t NewWord = Dst[Idx] & ~Src[Idx];
+    Diff |= NewWord ^ Dst[Idx];
+    Dst[Idx] = NewWord;
+  }
+  return Diff != 0;
+}
+
+#if defined(DFA_MEET_KERNELS_X86)
+
+/// @name SSE2 kernels (2 words per iteration)
+/// @{
+
+__attribute__((target("sse2"))) bool
+andSSE2(Word_t *const Dst, const Word_t *const Src,
+        const std::size_t NumWords) {
+  __m128i Diff = _mm_setzero_si128();
+  std::size_t Idx = 0;
+  for (; Idx + 2 <= NumWords; Idx += 2) {
+    __m128i *const DstPtr = reinterpret_cast<__m128i *>(Dst + Idx);
+    const __m128i OldVec = _mm_loadu_si128(DstPtr);
+    const __m128i NewVec = _mm_and_si128(
+        OldVec, _mm_loadu_si128(reinterpret_cast<const __m128i *>(Src + Idx)));
+    Diff = _mm_or_si128(Diff, _mm_xor_si128(OldVec, NewVec));
+    _mm_storeu_si128(DstPtr, NewVec);
+  }
+  const bool Changed =
+      _mm_movemask_epi8(_mm_cmpeq_epi8(Diff, _mm_setzero_si128())) != 0xFFFF;
+  return andScalar(Dst + Idx, Src + Idx, NumWords - Idx) || Changed;
+}
+
+__attribute__((target("sse2"))) bool
+orSSE2(Word_t *const Dst, const Word_t *const Src,
+       const std::size_t NumWords) {
+  __m128i Diff = _mm_setzero_si128();
+  std::size_t Idx = 0;
+  for (; Idx + 2 <= NumWords; Idx += 2) {
+    __m128i *const DstPtr = reinterpret_cast<__m128i *>(Dst + Idx);
+    const __m128i OldVec = _mm_loadu_si128(DstPtr);
+    const __m128i NewVec = _mm_or_si128(
+        OldVec, _mm_loadu_si128(reinterpret_cast<const __m128i *>(Src + Idx)));
+    Diff = _mm_or_si128(Diff, _mm_xor_si128(OldVec, NewVec));
+    _mm_storeu_si128(DstPtr, NewVec);
+  }
+  const bool Changed =
+      _mm_movemask_epi8(_mm_cmpeq_epi8(Diff, _mm_setzero_si128())) != 0xFFFF;
+  return orScalar(Dst + Idx, Src + Idx, NumWords - Idx) || Changed;
+}
+
+__attribute__((target("sse2"))) bool
+andNotSSE2(Word_t *const Dst, const Word_t *const Src,
+           const std::size_t NumWords) {
+  __m128i Diff = _mm_setzero_si128();
+  std::size_t Idx = 0;
+  for (; Idx + 2 <= NumWords; Idx += 2) {
+    __m128i *const DstPtr = reinterpret_cast<__m128i *>(Dst + Idx);
+    const __m128i OldVec = _mm_loadu_si128(DstPtr);
+    // _mm_andnot_si128 complements its first operand.
+    const __m128i NewVec = _mm_andnot_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Src + Idx)), OldVec);
+    Diff = _mm_or_si128(Diff, _mm_xor_si128(OldVec, NewVec));
+    _mm_storeu_si128(DstPtr, NewVec);
+  }
+  const bool Changed =
+      _mm_movemask_epi8(_mm_cmpeq_epi8(Diff, _mm_setzero_si128())) != 0xFFFF;
+  return andNotScalar(Dst + Idx, Src + Idx, NumWords - Idx) || Changed;
+}
+
+/// @}
+/// @name AVX2 kernels (4 words per iteration)
+/// @{
+
+__attribute__((target("avx2"))) bool
+andAVX2(Word_t *const Dst, const Word_t *const Src,
+        const std::size_t NumWords) {
+  __m256i Diff = _mm256_setzero_si256();
+  std::size_t Idx = 0;
+  for (; Idx + 4 <= NumWords; Idx += 4) {
+    __m256i *const DstPtr = reinterpret_cast<__m256i *>(Dst + Idx);
+    const __m256i OldVec = _mm256_loadu_si256(DstPtr);
+    const __m256i NewVec = _mm256_and_si256(
+        OldVec,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Src + Idx)));
+    Diff = _mm256_or_si256(Diff, _mm256_xor_si256(OldVec, NewVec));
+    _mm256_storeu_si256(DstPtr, NewVec);
+  }
+  const bool Changed = !_mm256_testz_si256(Diff, Diff);
+  return andScalar(Dst + Idx, Src + Idx, NumWords - Idx) || Changed;
+}
+
+__attribute__((target("avx2"))) bool
+orAVX2(Word_t *const Dst, const Word_t *const Src,
+       const std::size_t NumWords) {
+  __m256i Diff = _mm256_setzero_si256();
+  std::size_t Idx = 0;
+  for (; Idx + 4 <= NumWords; Idx += 4) {
+    __m256i *const DstPtr = reinterpret_cast<__m256i *>(Dst + Idx);
+    const __m256i OldVec = _mm256_loadu_si256(DstPtr);
+    const __m256i NewVec = _mm256_or_si256(
+        OldVec,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Src + Idx)));
+    Diff = _mm256_or_si256(Diff, _mm256_xor_si256(OldVec, NewVec));
+    _mm256_storeu_si256(DstPtr, NewVec);
+  }
+  const bool Changed = !_mm256_testz_si256(Diff, Diff);
+  return orScalar(Dst + Idx, Src + Idx, NumWords - Idx) || Changed;
+}
+
+__attribute__((target("avx2"))) bool
+andNotAVX2(Word_t *const Dst, const Word_t *const Src,
+           const std::size_t NumWords) {
+  __m256i Diff = _mm256_setzero_si256();
+  std::size_t Idx = 0;
+  for (; Idx + 4 <= NumWords; Idx += 4) {
+    __m256i *const DstPtr = reinterpret_cast<__m256i *>(Dst + Idx);
+    const __m256i OldVec = _mm256_loadu_si256(DstPtr);
+    const __m256i NewVec = _mm256_andnot_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Src + Idx)),
+        OldVec);
+    Diff = _mm256_or_si256(Diff, _mm256_xor_si256(OldVec, NewVec));
+    _mm256_storeu_si256(DstPtr, NewVec);
+  }
+  const bool Changed = !_mm256_testz_si256(Diff, Diff);
+  return andNotScalar(Dst + Idx, Src + Idx, NumWords - Idx) || Changed;
+}
+
+/// @}
+
+#endif // DFA_MEET_KERNELS_X86
+
+const MeetKernels ScalarKernels = {
+    .And = andScalar, .Or = orScalar, .AndNot = andNotScalar};
+#if defined(DFA_MEET_KERNELS_X86)
+const MeetKernels SSE2Kernels = {
+    .And = andSSE2, .Or = orSSE2, .AndNot = andNotSSE2};
+const MeetKernels AVX2Kernels = {
+    .And = andAVX2, .Or = orAVX2, .AndNot = andNotAVX2};
+#endif
+
+} // anonymous namespace
+
+const char *getISAName(const ISA Kind) {
+  switch (Kind) {
+  case ISA::Scalar:
+    return "scalar";
+  case ISA::SSE2:
+    return "sse2";
+  case ISA::AVX2:
+    return "avx2";
+  }
+  return "unknown";
+}
+
+bool isISASupported(const ISA Kind) {
+  switch (Kind) {
+  case ISA::Scalar:
+    return true;
+#if defined(DFA_MEET_KERNELS_X86)
+  case ISA::SSE2:
+    return __builtin_cpu_supports("sse2");
+  case ISA::AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+const MeetKernels &getMeetKernels(const ISA Kind) {
+  if (!isISASupported(Kind)) {
+    return ScalarKernels;
+  }
+  switch (Kind) {
+#if defined(DFA_MEET_KERNELS_X86)
+  case ISA::SSE2:
+    return SSE2Kernels;
+  case ISA::AVX2:
+    return AVX2Kernels;
+#endif
+  default:
+    return ScalarKernels;
+  }
+}
+
+const MeetKernels &getMeetKernels() {
+  static const MeetKernels &Kernels = getMeetKernels(
+      isISASupported(ISA::AVX2)
+          ? ISA::AVX2
+          : (isISASupported(ISA::SSE2) ? ISA::SSE2 : ISA::Scalar));
+  return Kernels;
+}
+
+} // namespace kernel
+} // namespace dfa
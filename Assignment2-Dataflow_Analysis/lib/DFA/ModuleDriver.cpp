@@ -0,0 +1,9 @@
+#include <DFA/ModuleDriver.h>
+
+using namespace llvm;
+
+cl::opt<unsigned> dfa::NumThreads(
+    "dfa-threads",
+    cl::desc("Number of threads used by the module-level dataflow drivers "
+             "(0 uses all the available hardware threads)"),
+    cl::init(0));
@@ -1,6 +1,13 @@
 ; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=avail-expr %s -o %basename_t 2>%basename_t.log
-; @todo(CSCD70): FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN:     -p=avail-expr -dfa-solver=sweep %s -o %basename_t \
+; RUN:     2>%basename_t.sweep.log
+; RUN: FileCheck --match-full-lines %s --check-prefixes=CHECK,SWEEP \
+; RUN:     --input-file=%basename_t.sweep.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=avail-expr -dfa-solver=worklist %s -o %basename_t \
+; RUN:     2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --check-prefixes=CHECK,WORKLIST \
+; RUN:     --input-file=%basename_t.log
 
 ; int main(int argc, char *argv[]) {
 ;   int a, b, c, d, e, f;
@@ -19,28 +26,45 @@
 ;   d = b + f;
 ;   return 0;
 ; }
-; @todo(CSCD70) Please complete the CHECK directives.
 define i32 @main(i32 noundef %0, ptr noundef %1) {
-; [AvailExpr]     {}
+; CHECK:      CHECK: [AvailExprs] {}
   %3 = add nsw i32 %0, 50
-; [AvailExpr]     {[add %0, 50], }
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], }
   %4 = add nsw i32 %3, 96
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], }
   %5 = icmp slt i32 50, %3
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], }
   br i1 %5, label %6, label %9
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], }
 
 6:                                                ; preds = %2
+; CHECK:      CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], }
   %7 = sub nsw i32 %3, 50
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [sub %3, 50], }
   %8 = mul nsw i32 96, %3
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [sub %3, 50], [mul 96, %3], }
   br label %12
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [sub %3, 50], [mul 96, %3], }
 
 9:                                                ; preds = %2
+; CHECK:      CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], }
   %10 = add nsw i32 %3, 50
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [add %3, 50], }
   %11 = mul nsw i32 96, %3
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], [add %3, 50], }
   br label %12
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], [add %3, 50], }
 
 12:                                               ; preds = %9, %6
+; CHECK:      CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], }
   %.0 = phi i32 [ %7, %6 ], [ %10, %9 ]
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], }
   %13 = sub nsw i32 50, 96
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], [sub 50, 96], }
   %14 = add nsw i32 %13, %.0
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], [sub 50, 96], [add %13, %.0], }
   ret i32 0
+; CHECK-NEXT: CHECK: [AvailExprs] {[add %0, 50], [add %3, 96], [mul 96, %3], [sub 50, 96], [add %13, %.0], }
 }
+; SWEEP:    {{.*}}[AvailExprs] Converged after 8 basic block visits, at most 2 of one basic block
+; WORKLIST: {{.*}}[AvailExprs] Converged after 4 basic block visits, at most 1 of one basic block
@@ -0,0 +1,43 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=reg-pressure -dfa-verbosity=block %s -o %basename_t \
+; RUN:     2>%basename_t.log
+; RUN: FileCheck %s --input-file=%basename_t.log
+
+; int sum(int a, int b) {
+;   int res = 1;
+;   for (int i = a; i < b; i++) {
+;     res += i;
+;   }
+;   return res;
+; }
+;
+; In the loop header, `b` is live throughout, the PHI nodes from their
+; definitions on, and the comparison until the branch, hence the pressure goes
+; 2, 3, 4, 4.
+; CHECK:      [RegPressure] @sum: 7 live intervals (15 segments) over 10 instructions, max pressure 4, average 3.00
+; CHECK-NEXT: [RegPressure] Loop %3 (depth 1): max pressure 4, average 3.38
+; CHECK-NEXT: [RegPressure] Block %2: max pressure 2, average 2.00
+; CHECK-NEXT: [RegPressure] Block %3: max pressure 4, average 3.25
+; CHECK-NEXT: [RegPressure] Block %9: max pressure 1, average 1.00
+; CHECK-NEXT: [RegPressure] Block %5: max pressure 4, average 3.50
+; CHECK-NEXT: [RegPressure] Block %7: max pressure 4, average 3.50
+define i32 @sum(i32 noundef %0, i32 noundef %1) {
+  br label %3
+
+3:                                                ; preds = %7, %2
+  %.01 = phi i32 [ 1, %2 ], [ %6, %7 ]
+  %.0 = phi i32 [ %0, %2 ], [ %8, %7 ]
+  %4 = icmp slt i32 %.0, %1
+  br i1 %4, label %5, label %9
+
+5:                                                ; preds = %3
+  %6 = add nsw i32 %.01, %.0
+  br label %7
+
+7:                                                ; preds = %5
+  %8 = add nsw i32 %.0, 1
+  br label %3
+
+9:                                                ; preds = %3
+  ret i32 %.01
+}
@@ -0,0 +1,87 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so -dfa-verbosity=summary \
+; RUN:     -p=lcm %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck %s --check-prefix=IR --input-file=%basename_t
+; RUN: FileCheck %s --check-prefix=LOG --input-file=%basename_t.log
+
+declare void @use(i32)
+
+; int Diamond(int c, int a, int b) {
+;   if (c) use(a + b);
+;   return a + b;
+; }
+; LOG: CHECK: [LCM] @Diamond: inserted 1 and replaced 1 out of 2 computations, inserted 1 PHI nodes, split 1 out of 2 edges
+define i32 @Diamond(i1 %c, i32 %a, i32 %b) {
+; IR-LABEL: @Diamond(
+; IR:       entry.join_crit_edge:
+; IR-NEXT:    %x.lcm = add i32 %a, %b
+; IR:       then:
+; IR-NEXT:    %x = add i32 %a, %b
+; IR:       join:
+; IR-NEXT:    [[X:%.*]] = phi i32 [ %x.lcm, %entry.join_crit_edge ], [ %x, %then ]
+; IR-NEXT:    ret i32 [[X]]
+entry:
+  br i1 %c, label %then, label %join
+then:
+  %x = add nsw i32 %a, %b
+  call void @use(i32 %x)
+  br label %join
+join:
+  %y = add i32 %a, %b
+  ret i32 %y
+}
+
+; int DoWhile(int g, int a, int b, int n) {
+;   int s = 0, i = 0;
+;   if (g) do { s += a * b; } while (++i < n);
+;   return s;
+; }
+; LOG: CHECK: [LCM] @DoWhile: inserted 1 and replaced 1 out of 3 computations, inserted 0 PHI nodes, split 1 out of 4 edges
+define i32 @DoWhile(i1 %g, i32 %a, i32 %b, i32 %n) {
+; IR-LABEL: @DoWhile(
+; IR:       entry.body_crit_edge:
+; IR-NEXT:    %m.lcm = mul i32 %a, %b
+; IR-NEXT:    br label %body
+; IR:       body:
+; IR-NEXT:    %i = phi i32 [ 0, %entry.body_crit_edge ], [ %i.next, %body ]
+; IR-NEXT:    %s = phi i32 [ 0, %entry.body_crit_edge ], [ %s.next, %body ]
+; IR-NEXT:    %s.next = add i32 %s, %m.lcm
+entry:
+  br i1 %g, label %body, label %exit
+body:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %s = phi i32 [ 0, %entry ], [ %s.next, %body ]
+  %m = mul i32 %a, %b
+  %s.next = add i32 %s, %m
+  %i.next = add i32 %i, 1
+  %c = icmp slt i32 %i.next, %n
+  br i1 %c, label %body, label %exit
+exit:
+  %r = phi i32 [ 0, %entry ], [ %s.next, %body ]
+  ret i32 %r
+}
+
+; The computation is not hoisted above the calls that precede it, which would
+; only lengthen its live range.
+; LOG: CHECK: [LCM] @Lazy: inserted 0 and replaced 1 out of 2 computations, inserted 0 PHI nodes, split 0 out of 2 edges
+define i32 @Lazy(i1 %c, i32 %a, i32 %b) {
+; IR-LABEL: @Lazy(
+; IR:       j:
+; IR-NEXT:    call void @use(i32 2)
+; IR-NEXT:    %x = add i32 %a, %b
+; IR-NEXT:    call void @use(i32 %x)
+; IR-NEXT:    ret i32 %x
+entry:
+  br i1 %c, label %l, label %r
+l:
+  call void @use(i32 0)
+  br label %j
+r:
+  call void @use(i32 1)
+  br label %j
+j:
+  call void @use(i32 2)
+  %x = add i32 %a, %b
+  call void @use(i32 %x)
+  %y = add i32 %a, %b
+  ret i32 %y
+}
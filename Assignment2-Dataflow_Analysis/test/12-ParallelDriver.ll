@@ -0,0 +1,63 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=const-prop -dfa-verbosity=block %s -o %basename_t \
+; RUN:     2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=parallel-const-prop -dfa-threads=4 -dfa-verbosity=block %s \
+; RUN:     -o %basename_t 2>%basename_t.parallel.log
+; RUN: diff %basename_t.log %basename_t.parallel.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness -dfa-verbosity=summary %s -o %basename_t \
+; RUN:     2>%basename_t.liveness.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=parallel-liveness -dfa-threads=4 -dfa-verbosity=summary %s \
+; RUN:     -o %basename_t 2>%basename_t.liveness.parallel.log
+; RUN: diff %basename_t.liveness.log %basename_t.liveness.parallel.log
+
+; The module drivers solve the functions concurrently but print their results
+; in module order, which the dumps of the sequential passes are compared to.
+
+; CHECK:      CHECK: [SCCP] {i32 %1=NAC, }
+; CHECK-NEXT: CHECK: [SCCP] Converged after 3 instruction visits, 1 out of 1 basic blocks executable
+define i32 @Add(i32 %a, i32 %b) {
+  %1 = add nsw i32 %a, %b
+  ret i32 %1
+}
+
+; CHECK:      CHECK: [SCCP] {i32 %4=NAC, }
+; CHECK-NEXT: CHECK: [SCCP] Converged after 8 instruction visits, 4 out of 4 basic blocks executable
+define i32 @Select(i1 %c) {
+  br i1 %c, label %1, label %2
+
+1:
+  br label %3
+
+2:
+  br label %3
+
+3:
+  %4 = phi i32 [ 1, %1 ], [ 2, %2 ]
+  ret i32 %4
+}
+
+; CHECK:      CHECK: [SCCP] {i32 %1=42, }
+; CHECK-NEXT: CHECK: [SCCP] Converged after 3 instruction visits, 1 out of 1 basic blocks executable
+define i32 @Const() {
+  %1 = add nsw i32 20, 22
+  ret i32 %1
+}
+
+; CHECK: CHECK: [SCCP] {i32 %.0=NAC, i1 %2=NAC, i32 %3=NAC, }
+; CHECK: CHECK: [SCCP] Converged after 16 instruction visits, 3 out of 3 basic blocks executable
+define i32 @Count(i32 %n) {
+  br label %1
+
+1:
+  %.0 = phi i32 [ 0, %0 ], [ %3, %1 ]
+  %2 = icmp slt i32 %.0, %n
+  %3 = add nsw i32 %.0, 1
+  br i1 %2, label %1, label %4
+
+4:
+  ret i32 %.0
+}
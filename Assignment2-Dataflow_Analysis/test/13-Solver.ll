@@ -0,0 +1,79 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness -dfa-solver=sweep %s -o %basename_t \
+; RUN:     2>%basename_t.liveness.sweep.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness -dfa-solver=worklist %s -o %basename_t \
+; RUN:     2>%basename_t.liveness.worklist.log
+; RUN: FileCheck %s --check-prefix=LIVENESS-SWEEP \
+; RUN:     --input-file=%basename_t.liveness.sweep.log
+; RUN: FileCheck %s --check-prefix=LIVENESS-WORKLIST \
+; RUN:     --input-file=%basename_t.liveness.worklist.log
+; RUN: grep -v "Converged after" %basename_t.liveness.sweep.log \
+; RUN:     >%basename_t.liveness.sweep.dump
+; RUN: grep -v "Converged after" %basename_t.liveness.worklist.log \
+; RUN:     >%basename_t.liveness.worklist.dump
+; RUN: diff %basename_t.liveness.sweep.dump %basename_t.liveness.worklist.dump
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=avail-expr -dfa-solver=sweep %s -o %basename_t \
+; RUN:     2>%basename_t.avail.sweep.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=avail-expr -dfa-solver=worklist %s -o %basename_t \
+; RUN:     2>%basename_t.avail.worklist.log
+; RUN: FileCheck %s --check-prefix=AVAIL-SWEEP \
+; RUN:     --input-file=%basename_t.avail.sweep.log
+; RUN: FileCheck %s --check-prefix=AVAIL-WORKLIST \
+; RUN:     --input-file=%basename_t.avail.worklist.log
+; RUN: grep -v "Converged after" %basename_t.avail.sweep.log \
+; RUN:     >%basename_t.avail.sweep.dump
+; RUN: grep -v "Converged after" %basename_t.avail.worklist.log \
+; RUN:     >%basename_t.avail.worklist.dump
+; RUN: diff %basename_t.avail.sweep.dump %basename_t.avail.worklist.dump
+
+; int nest(int n, int m) {
+;   int s = 0;
+;   for (int i = 0; i < n; i++) {
+;     for (int j = 0; j < m; j++) {
+;       s += i * j;
+;     }
+;   }
+;   return s;
+; }
+;
+; Both solvers reach the same fixpoint, but the sweeps revisit every block
+; until nothing changes, while the worklist only revisits the blocks whose
+; inputs changed.
+; LIVENESS-SWEEP:    CHECK: [Liveness] Converged after 28 basic block visits, at most 4 of one basic block
+; LIVENESS-WORKLIST: CHECK: [Liveness] Converged after 16 basic block visits, at most 4 of one basic block
+; AVAIL-SWEEP:       CHECK: [AvailExprs] Converged after 14 basic block visits, at most 2 of one basic block
+; AVAIL-WORKLIST:    CHECK: [AvailExprs] Converged after 9 basic block visits, at most 2 of one basic block
+define i32 @nest(i32 noundef %0, i32 noundef %1) {
+  br label %3
+
+3:                                                ; preds = %12, %2
+  %.02 = phi i32 [ 0, %2 ], [ %.1, %12 ]
+  %.0 = phi i32 [ 0, %2 ], [ %13, %12 ]
+  %4 = icmp slt i32 %.0, %0
+  br i1 %4, label %5, label %14
+
+5:                                                ; preds = %10, %3
+  %.1 = phi i32 [ %.02, %3 ], [ %9, %10 ]
+  %.01 = phi i32 [ 0, %3 ], [ %11, %10 ]
+  %6 = icmp slt i32 %.01, %1
+  br i1 %6, label %7, label %12
+
+7:                                                ; preds = %5
+  %8 = mul nsw i32 %.0, %.01
+  %9 = add nsw i32 %.1, %8
+  br label %10
+
+10:                                               ; preds = %7
+  %11 = add nsw i32 %.01, 1
+  br label %5
+
+12:                                               ; preds = %5
+  %13 = add nsw i32 %.0, 1
+  br label %3
+
+14:                                               ; preds = %3
+  ret i32 %.02
+}
@@ -1,6 +1,13 @@
 ; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=liveness %s -o %basename_t 2>%basename_t.log
-; @todo(CSCD70): FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN:     -p=liveness -dfa-solver=sweep %s -o %basename_t \
+; RUN:     2>%basename_t.sweep.log
+; RUN: FileCheck --match-full-lines %s --check-prefixes=CHECK,SWEEP \
+; RUN:     --input-file=%basename_t.sweep.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness -dfa-solver=worklist %s -o %basename_t \
+; RUN:     2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --check-prefixes=CHECK,WORKLIST \
+; RUN:     --input-file=%basename_t.log
 
 ; int sum(int a, int b) {
 ;   int res = 1;
@@ -9,24 +16,45 @@
 ;   }
 ;   return res;
 ; }
-; @todo(CSCD70) Please complete the CHECK directives.
 define i32 @sum(i32 noundef %0, i32 noundef %1) {
+; CHECK:      CHECK: [Liveness] {i32 %0, i32 %1, }
   br label %3
+; CHECK-EMPTY:
+; CHECK-NEXT: CHECK: [Liveness] {i32 %6, i32 %0, i32 %8, i32 %1, }
 
 3:                                                ; preds = %7, %2
+; CHECK:      CHECK: [Liveness] {i32 %6, i32 %0, i32 %8, i32 %1, }
   %.01 = phi i32 [ 1, %2 ], [ %6, %7 ]
+; CHECK-NEXT: CHECK: [Liveness] {i32 %0, i32 %8, i32 %1, i32 %.01, }
   %.0 = phi i32 [ %0, %2 ], [ %8, %7 ]
+; CHECK-NEXT: CHECK: [Liveness] {i32 %.0, i32 %1, i32 %.01, }
   %4 = icmp slt i32 %.0, %1
+; CHECK-NEXT: CHECK: [Liveness] {i32 %.0, i32 %1, i1 %4, i32 %.01, }
   br i1 %4, label %5, label %9
+; CHECK-EMPTY:
+; CHECK-NEXT: CHECK: [Liveness] {i32 %.0, i32 %1, i32 %.01, }
 
 5:                                                ; preds = %3
+; CHECK:      CHECK: [Liveness] {i32 %.0, i32 %1, i32 %.01, }
   %6 = add nsw i32 %.01, %.0
+; CHECK-NEXT: CHECK: [Liveness] {i32 %6, i32 %.0, i32 %1, }
   br label %7
+; CHECK-EMPTY:
+; CHECK-NEXT: CHECK: [Liveness] {i32 %6, i32 %.0, i32 %1, }
 
 7:                                                ; preds = %5
+; CHECK:      CHECK: [Liveness] {i32 %6, i32 %.0, i32 %1, }
   %8 = add nsw i32 %.0, 1
+; CHECK-NEXT: CHECK: [Liveness] {i32 %6, i32 %8, i32 %1, }
   br label %3
+; CHECK-EMPTY:
+; CHECK-NEXT: CHECK: [Liveness] {i32 %6, i32 %0, i32 %8, i32 %1, }
 
 9:                                                ; preds = %3
+; CHECK:      CHECK: [Liveness] {i32 %.01, }
   ret i32 %.01
+; CHECK-EMPTY:
+; CHECK-NEXT: CHECK: [Liveness] {}
 }
+; SWEEP:    {{.*}}[Liveness] Converged after 15 basic block visits, at most 3 of one basic block
+; WORKLIST: {{.*}}[Liveness] Converged after 8 basic block visits, at most 2 of one basic block
@@ -1,6 +1,7 @@
 ; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=const-prop %s -o %basename_t 2>%basename_t.log
-; @todo(CSCD70): FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN:     -p=const-prop -dfa-verbosity=block %s -o %basename_t \
+; RUN:     2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
 
 ; int Loop() {
 ;   int i = 1, j = 1;
@@ -15,8 +16,11 @@
 ;   }
 ;   return j;
 ; }
-; @todo(CSCD70) Please complete the CHECK directives.
+;
+; The else branch is never taken, since j stays 1, hence the PHI node that
+; merges it is constant too, even though its incoming value from there is not.
 define i32 @Loop() {
+; CHECK: CHECK: [SCCP] {}
   br label %1
 
 1:                                                ; preds = %9, %0
@@ -24,24 +28,32 @@ define i32 @Loop() {
   %.0 = phi i32 [ 0, %0 ], [ %.1, %9 ]
   %2 = icmp slt i32 %.0, 100
   br i1 %2, label %3, label %10
+; CHECK: CHECK: [SCCP] {i32 %.01=1, i32 %.0=NAC, i1 %2=NAC, }
 
 3:                                                ; preds = %1
   %4 = icmp slt i32 %.01, 20
   br i1 %4, label %5, label %7
+; CHECK: CHECK: [SCCP] {i1 %4=1, }
 
 5:                                                ; preds = %3
   %6 = add nsw i32 %.0, 1
   br label %9
+; CHECK: CHECK: [SCCP] {i32 %6=NAC, }
 
 7:                                                ; preds = %3
   %8 = add nsw i32 %.0, 2
   br label %9
+; CHECK:      CHECK: [SCCP] Not executable
+; CHECK-NEXT: CHECK: [SCCP] {}
 
 9:                                                ; preds = %7, %5
   %.12 = phi i32 [ 1, %5 ], [ %.0, %7 ]
   %.1 = phi i32 [ %6, %5 ], [ %8, %7 ]
   br label %1
+; CHECK: CHECK: [SCCP] {i32 %.12=1, i32 %.1=NAC, }
 
 10:                                               ; preds = %1
   ret i32 %.01
+; CHECK:      CHECK: [SCCP] {}
+; CHECK-NEXT: CHECK: [SCCP] Converged after 30 instruction visits, 6 out of 7 basic blocks executable
 }
@@ -1,6 +1,6 @@
-; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so -dfa-verbosity=summary \
 ; RUN:     -p=lcm %s -o %basename_t 2>%basename_t.log
-; @todo(CSCD70): FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
 
 ; #include "stdio.h"
 
@@ -18,10 +18,16 @@
 ;   int e = b + c;
 ;   return e;
 ; }
-; @todo(CSCD70) Please complete the CHECK directives. Note that:
-;               - The critical edges have to be broken first.
-;               - The outputs from both the 4 analysis passes and the 2
-;                 placements have to be checked.
+; The edges into %9 and %16 are split first. Every `b + c` computes a
+; different expression in SSA form, hence each of them is placed earliest and
+; latest right where it is, and nothing is moved.
+; CHECK: CHECK: [AnticipatedExprs] Converged after 14 basic block visits, at most 2 of one basic block
+; CHECK-NEXT: CHECK: [WBAvailExprs] Converged after 12 basic block visits, at most 2 of one basic block
+; CHECK-NEXT: CHECK: [EarliestPlacement] Placed 4 computations before 4 instructions
+; CHECK-NEXT: CHECK: [PostponableExprs] Converged after 12 basic block visits, at most 2 of one basic block
+; CHECK-NEXT: CHECK: [LatestPlacement] Placed 4 computations before 4 instructions
+; CHECK-NEXT: CHECK: [UsedExprs] Converged after 11 basic block visits, at most 1 of one basic block
+; CHECK-NEXT: CHECK: [LCM] @foo: inserted 0 and replaced 0 out of 4 computations, inserted 0 PHI nodes, split 0 out of 4 edges
 @.str = private unnamed_addr constant [3 x i8] c"%d\00", align 1
 
 define i32 @foo(i32 noundef %0, i32 noundef %1, i32 noundef %2) #0 {
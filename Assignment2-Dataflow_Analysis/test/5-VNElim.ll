@@ -0,0 +1,62 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=vn-elim %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck %s --input-file=%basename_t
+
+; int Redundant(int a, int b, int c, int p) {
+;   int x = a + b, y = b + a;
+;   int z = c + 0, s = a - a;
+;   int t = p ? a + b : b + a;
+;   return x * 2 + 2 * y + (3 + 4) + z + s + t;
+; }
+define i32 @Redundant(i32 %a, i32 %b, i32 %c, i1 %p) {
+; CHECK:       %x = add i32 %a, %b
+; CHECK-NEXT:  %m1 = mul i32 %x, 2
+; CHECK-NEXT:  br i1 %p, label %t, label %e
+entry:
+  %x = add nsw i32 %a, %b
+  %y = add i32 %b, %a
+  %m1 = mul i32 %x, 2
+  %m2 = mul i32 2, %y
+  %k = add i32 3, 4
+  %z = add i32 %c, 0
+  %s = sub i32 %a, %a
+  br i1 %p, label %t, label %e
+
+t:
+  %t1 = add i32 %a, %b
+  br label %j
+
+e:
+  %e1 = add i32 %b, %a
+  br label %j
+
+; CHECK-LABEL: j:
+; CHECK-NEXT:  %r0 = add i32 %m1, %m1
+; CHECK-NEXT:  %r1 = add i32 %r0, 7
+; CHECK-NEXT:  %r2 = add i32 %r1, %c
+; CHECK-NEXT:  %r4 = add i32 %r2, %x
+; CHECK-NEXT:  ret i32 %r4
+j:
+  %ph = phi i32 [ %t1, %t ], [ %e1, %e ]
+  %r0 = add i32 %m1, %m2
+  %r1 = add i32 %r0, %k
+  %r2 = add i32 %r1, %z
+  %r3 = add i32 %r2, %s
+  %r4 = add i32 %r3, %ph
+  ret i32 %r4
+}
+
+; An unreachable block may define a value in terms of itself, which is left
+; opaque instead of being numbered recursively.
+define i32 @SelfUse(i32 %a) {
+; CHECK-LABEL: @SelfUse(
+; CHECK:       dead:
+; CHECK-NEXT:    %y = add i32 %y, 1
+; CHECK-NEXT:    br label %dead
+entry:
+  ret i32 %a
+
+dead:
+  %y = add i32 %y, 1
+  br label %dead
+}
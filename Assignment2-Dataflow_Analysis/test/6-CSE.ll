@@ -0,0 +1,43 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=cse %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck %s --input-file=%basename_t
+
+; int Merge(int a, int b, int p, int n) {
+;   int x = p ? a + b : b + a;
+;   int y = (a + b) * 3, i = 0;
+;   do { i += (a + b) * 3; } while (i < n);
+;   return i + y;
+; }
+define i32 @Merge(i32 %a, i32 %b, i1 %p, i32 %n) {
+entry:
+  br i1 %p, label %t, label %e
+; CHECK:       t:
+; CHECK-NEXT:    %x1 = add i32 %a, %b
+t:
+  %x1 = add nsw i32 %a, %b
+  br label %j
+e:
+  %x2 = add i32 %b, %a
+  br label %j
+; CHECK:       j:
+; CHECK-NEXT:    [[X:%.*]] = phi i32 [ %x2, %e ], [ %x1, %t ]
+; CHECK-NEXT:    %y = mul i32 [[X]], 3
+; CHECK-NEXT:    br label %h
+j:
+  %x3 = add i32 %a, %b
+  %y = mul i32 %x3, 3
+  br label %h
+; CHECK:       h:
+; CHECK-NEXT:    %i = phi i32 [ 0, %j ], [ %i2, %h ]
+; CHECK-NEXT:    %i2 = add i32 %i, %y
+h:
+  %i = phi i32 [ 0, %j ], [ %i2, %h ]
+  %x4 = add i32 %a, %b
+  %y2 = mul i32 %x4, 3
+  %i2 = add i32 %i, %y2
+  %c = icmp slt i32 %i2, %n
+  br i1 %c, label %h, label %x
+x:
+  %r = add i32 %i2, %y
+  ret i32 %r
+}
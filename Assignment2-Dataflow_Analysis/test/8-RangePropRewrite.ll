@@ -0,0 +1,78 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=range-prop-rewrite %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck %s --input-file=%basename_t
+
+; int Bounds() {
+;   int i = 0;
+;   for (; i < 100; ++i) {
+;     if ((unsigned)i >= 200)
+;       abort();
+;   }
+;   return i & 255;
+; }
+; CHECK-LABEL: @Bounds(
+define i32 @Bounds() {
+entry:
+  br label %h
+h:
+  %i = phi i32 [ 0, %entry ], [ %i2, %ok ]
+  %c = icmp slt i32 %i, 100
+  br i1 %c, label %b, label %x
+; CHECK:       b:
+; CHECK-NEXT:    %in = icmp ult i32 %i, 200
+; CHECK-NEXT:    br label %ok
+; CHECK-NOT:   call void @abort()
+b:
+  %in = icmp ult i32 %i, 200
+  br i1 %in, label %ok, label %oob
+oob:
+  call void @abort()
+  br label %ok
+; CHECK:       ok:
+; CHECK-SAME:    preds = %b
+ok:
+  %i2 = add nsw i32 %i, 1
+  br label %h
+x:
+  %r = and i32 %i, 255
+  ret i32 %r
+}
+
+
+; The loop header is widened to `[0, INT_MAX]` and then narrowed back to
+; `[0, 100]`, hence `i` is exactly 100 once the loop exits.
+;
+; int Narrow() {
+;   int i = 0;
+;   while (i < 100)
+;     ++i;
+;   if (i > 100)
+;     abort();
+;   return i;
+; }
+; CHECK-LABEL: @Narrow(
+define i32 @Narrow() {
+entry:
+  br label %h
+h:
+  %i = phi i32 [ 0, %entry ], [ %i2, %b ]
+  %c = icmp slt i32 %i, 100
+  br i1 %c, label %b, label %x
+b:
+  %i2 = add nsw i32 %i, 1
+  br label %h
+; CHECK:       x:
+; CHECK-NEXT:    %gt = icmp sgt i32 %i, 100
+; CHECK-NEXT:    br label %done
+; CHECK-NOT:   call void @abort()
+x:
+  %gt = icmp sgt i32 %i, 100
+  br i1 %gt, label %oob, label %done
+oob:
+  call void @abort()
+  br label %done
+done:
+  ret i32 %i
+}
+
+declare void @abort()
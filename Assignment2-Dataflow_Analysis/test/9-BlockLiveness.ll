@@ -0,0 +1,113 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=block-liveness -dfa-verbosity=block %s -o %basename_t \
+; RUN:     2>%basename_t.log
+; RUN: FileCheck %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=ssa-liveness -dfa-verbosity=block %s -o %basename_t \
+; RUN:     2>%basename_t.ssa.log
+; RUN: FileCheck %s --input-file=%basename_t.ssa.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness-check %s -o %basename_t 2>%basename_t.check.log
+; RUN: FileCheck %s --check-prefix=CROSS --input-file=%basename_t.check.log
+
+; int sum(int a, int b) {
+;   int res = 1;
+;   for (int i = a; i < b; i++) {
+;     res += i;
+;   }
+;   return res;
+; }
+;
+; Both the iterative and the SSA-based engines print, for every block, its
+; live-in set and then its live-out set. The incoming values of the PHI nodes
+; are only live out of their incoming blocks, and the PHI nodes are not live
+; into their own block.
+; CROSS: Checked 2 functions (12 basic blocks), 0 mismatches
+define i32 @sum(i32 noundef %0, i32 noundef %1) {
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, }
+  br label %3
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %1, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %1, i32 %.01, i32 %.0, }
+3:                                                ; preds = %7, %2
+  %.01 = phi i32 [ 1, %2 ], [ %6, %7 ]
+  %.0 = phi i32 [ %0, %2 ], [ %8, %7 ]
+  %4 = icmp slt i32 %.0, %1
+  br i1 %4, label %5, label %9
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %1, i32 %.01, i32 %.0, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %1, i32 %.0, i32 %6, }
+5:                                                ; preds = %3
+  %6 = add nsw i32 %.01, %.0
+  br label %7
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %1, i32 %.0, i32 %6, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %1, i32 %6, i32 %8, }
+7:                                                ; preds = %5
+  %8 = add nsw i32 %.0, 1
+  br label %3
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %.01, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {}
+9:                                                ; preds = %3
+  ret i32 %.01
+}
+
+; int nest(int n, int m) {
+;   int s = 0;
+;   for (int i = 0; i < n; i++) {
+;     for (int j = 0; j < m; j++) {
+;       s += i * j;
+;     }
+;   }
+;   return s;
+; }
+;
+; The values that are live around the outer loop are live throughout the inner
+; one as well, and the cross-check covers both loops of the nest.
+define i32 @nest(i32 noundef %0, i32 noundef %1) {
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, }
+  br label %3
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.02, i32 %.0, }
+3:                                                ; preds = %12, %2
+  %.02 = phi i32 [ 0, %2 ], [ %.1, %12 ]
+  %.0 = phi i32 [ 0, %2 ], [ %13, %12 ]
+  %4 = icmp slt i32 %.0, %0
+  br i1 %4, label %5, label %14
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, i32 %.1, i32 %.01, }
+5:                                                ; preds = %10, %3
+  %.1 = phi i32 [ %.02, %3 ], [ %9, %10 ]
+  %.01 = phi i32 [ 0, %3 ], [ %11, %10 ]
+  %6 = icmp slt i32 %.01, %1
+  br i1 %6, label %7, label %12
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, i32 %.1, i32 %.01, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, i32 %.01, i32 %9, }
+7:                                                ; preds = %5
+  %8 = mul nsw i32 %.0, %.01
+  %9 = add nsw i32 %.1, %8
+  br label %10
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, i32 %.01, i32 %9, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, i32 %9, i32 %11, }
+10:                                               ; preds = %7
+  %11 = add nsw i32 %.01, 1
+  br label %5
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.0, i32 %.1, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {i32 %0, i32 %1, i32 %.1, i32 %13, }
+12:                                               ; preds = %5
+  %13 = add nsw i32 %.0, 1
+  br label %3
+
+; CHECK:      [{{Block|SSA}}Liveness] {i32 %.02, }
+; CHECK-NEXT: [{{Block|SSA}}Liveness] {}
+14:                                               ; preds = %3
+  ret i32 %.02
+}